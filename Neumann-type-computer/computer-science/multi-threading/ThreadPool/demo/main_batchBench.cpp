@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "../include/ThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief tiny task which only counts itself
+ */
+class CountTask : public Executable {
+    private:
+        std::atomic<size_t> &m_count;
+
+    public:
+        explicit CountTask(std::atomic<size_t> &count) : m_count(count) {}
+
+        const char *getDescriptionString() override {return "CountTask";}
+        void run(ThreadInfo) override {m_count.fetch_add(1, std::memory_order_relaxed);}
+};
+
+/**
+ * @brief The old way: create a pool, run one batch, close and join it, for every batch.
+ *
+ * @return the time per batch [us]
+ */
+static double measureRecreate(unsigned int numWorkers, size_t numBatches, size_t batchSize) {
+    std::atomic<size_t> count{0};
+    const auto startTime = Clock::now();
+    for (size_t b=0; b<numBatches; ++b) {
+        ThreadPool threadPool(numWorkers, batchSize);
+        for (size_t i=0; i<batchSize; ++i) {
+            threadPool.emplaceExecutable<CountTask>(count);
+        }
+        threadPool.closeInlet();
+        threadPool.join();
+    }
+    const double elapsed_us = std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+    if (count != numBatches*batchSize) {printf("lost tasks\n");}
+    return elapsed_us/numBatches;
+}
+
+/**
+ * @brief The new way: one pool runs all the batches, waiting for each one by `finishBatch`.
+ *
+ * @return the time per batch [us]
+ */
+static double measureReuse(unsigned int numWorkers, size_t numBatches, size_t batchSize) {
+    std::atomic<size_t> count{0};
+    ThreadPool threadPool(numWorkers, batchSize);
+    const auto startTime = Clock::now();
+    for (size_t b=0; b<numBatches; ++b) {
+        for (size_t i=0; i<batchSize; ++i) {
+            threadPool.emplaceExecutable<CountTask>(count);
+        }
+        threadPool.finishBatch();
+    }
+    const double elapsed_us = std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+    threadPool.closeInlet();
+    threadPool.join();
+    if (count != numBatches*batchSize) {printf("lost tasks\n");}
+    return elapsed_us/numBatches;
+}
+
+int main() {
+    const unsigned int numWorkers = std::max(2u, std::thread::hardware_concurrency());
+    constexpr size_t numBatches = 1000;
+
+    printf("batch size, re-created pool [us/batch], reused pool with finishBatch [us/batch]\n");
+    for (size_t batchSize : {1, 10, 100, 1000}) {
+        printf("%zu, %.1f, %.1f\n", batchSize, measureRecreate(numWorkers, numBatches, batchSize), measureReuse(numWorkers, numBatches, batchSize));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/BroadcastQueue.hpp"
+#include "../include/MultiThreadQueue.hpp"
+
+using SampleBlock = std::array<float, 1024>; // 4 KiB sample block
+
+/**
+ * @brief Fill a sample block as a signal source would.
+ */
+static void fillBlock(SampleBlock &block, size_t seq) {
+    for (size_t i=0; i<block.size(); ++i) {
+        block[i] = static_cast<float>(seq + i);
+    }
+}
+
+/**
+ * @brief Sum a sample block as an analysis stage would.
+ */
+static double sumBlock(const SampleBlock &block) {
+    double sum = 0;
+    for (const float x : block) {sum += x;}
+    return sum;
+}
+
+/**
+ * @brief Fan the stream out by copying every block into one `MultiThreadQueue` per consumer.
+ *
+ * @return throughput in blocks per second
+ */
+static double measureCopiedFanOut(size_t numConsumers, size_t numBlocks, size_t queueDepth) {
+    std::vector<std::unique_ptr<MultiThreadQueue<SampleBlock, RingStoragePolicy>>> queues;
+    for (size_t c=0; c<numConsumers; ++c) {queues.push_back(std::make_unique<MultiThreadQueue<SampleBlock, RingStoragePolicy>>(queueDepth));}
+    std::vector<double> checksums(numConsumers, 0);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumers;
+    for (size_t c=0; c<numConsumers; ++c) {
+        consumers.emplace_back([&queue = *queues[c], &checksum = checksums[c]]{
+            const auto block = std::make_unique<SampleBlock>();
+            while (queue.pop(*block)) {checksum += sumBlock(*block);}
+        });
+    }
+    const auto block = std::make_unique<SampleBlock>();
+    for (size_t i=0; i<numBlocks; ++i) {
+        fillBlock(*block, i);
+        for (auto &queue : queues) {queue->push(*block);}
+    }
+    for (auto &queue : queues) {queue->closeInlet();}
+    for (auto &th : consumers) {th.join();}
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+    printf("(checksum %.6e) ", checksums.back());
+    return numBlocks/elapsedTime.count();
+}
+
+/**
+ * @brief Fan the stream out through one `BroadcastQueue`, which every consumer reads in place.
+ *
+ * @return throughput in blocks per second
+ */
+static double measureBroadcast(size_t numConsumers, size_t numBlocks, size_t queueDepth) {
+    BroadcastQueue<SampleBlock> queue(queueDepth, numConsumers);
+    std::vector<double> checksums(numConsumers, 0);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumers;
+    for (size_t c=0; c<numConsumers; ++c) {
+        consumers.emplace_back([&queue, &checksum = checksums[c], c]{
+            while (const SampleBlock *block = queue.borrow(c)) {
+                checksum += sumBlock(*block);
+                queue.release(c);
+            }
+        });
+    }
+    const auto block = std::make_unique<SampleBlock>();
+    for (size_t i=0; i<numBlocks; ++i) {
+        fillBlock(*block, i);
+        queue.emplace(*block); // the only copy, shared by all the consumers
+    }
+    queue.closeInlet();
+    for (auto &th : consumers) {th.join();}
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+    printf("(checksum %.6e) ", checksums.back());
+    return numBlocks/elapsedTime.count();
+}
+
+int main() {
+    constexpr size_t numConsumers = 3;
+    constexpr size_t numBlocks = 50000;
+    constexpr size_t queueDepth = 64;
+
+    printf("4 KiB blocks, %zu consumers, %zu blocks\n", numConsumers, numBlocks);
+    const double throughput_copied = measureCopiedFanOut(numConsumers, numBlocks, queueDepth);
+    printf("one MultiThreadQueue per consumer [block/s]: %.3e\n", throughput_copied);
+    const double throughput_broadcast = measureBroadcast(numConsumers, numBlocks, queueDepth);
+    printf("BroadcastQueue [block/s]: %.3e\n", throughput_broadcast);
+    printf("ratio: %.2f\n", throughput_broadcast/throughput_copied);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "../include/MultiThreadQueue.hpp"
+
+/**
+ * @brief Measure the throughput of `MultiThreadQueue` when producers and consumers move `batchSize` elements per lock acquisition.
+ *
+ * @param[in] numThreads the number of the producer threads, and also the number of the consumer threads
+ * @param[in] numElemsPerProducer the number of the elements each producer pushes
+ * @param[in] queueDepth the capacity of the queue
+ * @param[in] batchSize the number of the elements passed to `pushBulk` and `popBulk` at once, 0 means `push` and `pop` are used instead
+ * @return throughput in elements per second
+ */
+double measureThroughput(unsigned int numThreads, unsigned int numElemsPerProducer, size_t queueDepth, size_t batchSize) {
+    MultiThreadQueue<float> queue(queueDepth);
+    std::vector<std::thread> producers, consumers;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (unsigned int i=0; i<numThreads; ++i) {
+        consumers.emplace_back([&queue, batchSize]{
+            if (batchSize == 0) {
+                float sample;
+                while (queue.pop(sample)) {}
+            } else {
+                std::vector<float> samples(batchSize);
+                while (queue.popBulk(samples.begin(), batchSize) > 0) {}
+            }
+        });
+    }
+    for (unsigned int i=0; i<numThreads; ++i) {
+        producers.emplace_back([&queue, numElemsPerProducer, batchSize]{
+            if (batchSize == 0) {
+                for (unsigned int j=0; j<numElemsPerProducer; ++j) {
+                    queue.push(static_cast<float>(j));
+                }
+            } else {
+                std::vector<float> samples(batchSize);
+                for (unsigned int j=0; j<numElemsPerProducer; j+=batchSize) {
+                    const size_t n = std::min<size_t>(batchSize, numElemsPerProducer-j);
+                    for (size_t k=0; k<n; ++k) {samples[k] = static_cast<float>(j+k);}
+                    for (size_t k=0; k<n; k+=queue.pushBulk(samples.begin()+k, samples.begin()+n)) {}
+                }
+            }
+        });
+    }
+    for (auto &th : producers) {th.join();}
+    queue.closeInlet();
+    for (auto &th : consumers) {th.join();}
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+    return static_cast<double>(numThreads)*numElemsPerProducer/elapsedTime.count();
+}
+
+int main() {
+    constexpr unsigned int numElemsPerProducer = 1000000;
+    constexpr size_t queueDepth = 1024;
+    const unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency()/2);
+
+    printf("%ux%u producers x consumers, queueDepth=%zu\n", numThreads, numThreads, queueDepth);
+    printf("batch size, throughput [elem/s]\n");
+    printf("push/pop, %.3e\n", measureThroughput(numThreads, numElemsPerProducer, queueDepth, 0));
+    for (size_t batchSize=1; batchSize<=512; batchSize*=2) {
+        printf("%zu, %.3e\n", batchSize, measureThroughput(numThreads, numElemsPerProducer, queueDepth, batchSize));
+    }
+
+    return EXIT_SUCCESS;
+}
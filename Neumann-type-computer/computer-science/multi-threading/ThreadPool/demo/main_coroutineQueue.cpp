@@ -0,0 +1,110 @@
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "../include/MultiThreadQueue.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief executor which resumes coroutines on a few worker threads
+ */
+class WorkerExecutor : public CoroutineExecutor {
+    private:
+        MultiThreadQueue<std::coroutine_handle<>> m_handles;
+        std::vector<std::thread> m_threads;
+
+    public:
+        WorkerExecutor(unsigned int numThreads, size_t maxNumCoroutines) : m_handles(maxNumCoroutines) {
+            for (unsigned int i=0; i<numThreads; ++i) {
+                m_threads.emplace_back([this]{
+                    std::coroutine_handle<> handle;
+                    while (m_handles.pop(handle)) {
+                        handle.resume();
+                    }
+                });
+            }
+        }
+
+        ~WorkerExecutor() {
+            m_handles.closeInlet();
+            for (auto &th : m_threads) {th.join();}
+        }
+
+        void schedule(std::coroutine_handle<> handle) override {m_handles.push(handle);} // never blocks: every suspended coroutine fits in the queue
+};
+
+/**
+ * @brief coroutine which starts at once and destroys itself when it finishes
+ */
+struct DetachedCoroutine {
+    struct promise_type {
+        DetachedCoroutine get_return_object() {return {};}
+        std::suspend_never initial_suspend() noexcept {return {};}
+        std::suspend_never final_suspend() noexcept {return {};}
+        void return_void() {}
+        void unhandled_exception() {std::terminate();}
+    };
+};
+
+using MessageQueue = MultiThreadQueue<unsigned int>;
+
+/**
+ * @brief logical consumer: pops messages until the queue is drained
+ */
+static DetachedCoroutine consume(MessageQueue &queue, CoroutineExecutor &executor, std::atomic<size_t> &numConsumed, std::atomic<size_t> &numRunning) {
+    while (const std::optional<unsigned int> msg = co_await queue.asyncPop(executor)) {
+        numConsumed.fetch_add(1, std::memory_order_relaxed);
+    }
+    numRunning.fetch_sub(1, std::memory_order_release);
+}
+
+/**
+ * @brief logical producer: pushes `numMessages` messages
+ */
+static DetachedCoroutine produce(MessageQueue &queue, CoroutineExecutor &executor, unsigned int numMessages, std::atomic<size_t> &numRunning) {
+    for (unsigned int i=0; i<numMessages; ++i) {
+        co_await queue.asyncPush(i, executor);
+    }
+    numRunning.fetch_sub(1, std::memory_order_release);
+}
+
+/**
+ * @brief Run coroutine producers and consumers on `numThreads` worker threads, and print the throughput.
+ */
+static void measure(unsigned int numThreads, unsigned int numProducers, unsigned int numConsumers, unsigned int numMessagesPerProducer) {
+    MessageQueue queue(256);
+    std::atomic<size_t> numConsumed{0}, numProducersRunning{numProducers}, numConsumersRunning{numConsumers};
+    const auto startTime = Clock::now();
+    {
+        WorkerExecutor executor(numThreads, numProducers + numConsumers);
+        for (unsigned int i=0; i<numConsumers; ++i) {
+            consume(queue, executor, numConsumed, numConsumersRunning);
+        }
+        for (unsigned int i=0; i<numProducers; ++i) {
+            produce(queue, executor, numMessagesPerProducer, numProducersRunning);
+        }
+        while (numProducersRunning.load(std::memory_order_acquire) > 0) {std::this_thread::sleep_for(std::chrono::milliseconds(1));}
+        queue.closeInlet();
+        while (numConsumersRunning.load(std::memory_order_acquire) > 0) {std::this_thread::sleep_for(std::chrono::milliseconds(1));}
+    }
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - startTime).count();
+    printf("%u, %u, %u, %zu, %.3e\n", numThreads, numProducers, numConsumers, numConsumed.load(), numConsumed.load()/elapsed_s);
+}
+
+int main() {
+    constexpr unsigned int numMessages = 1000000;
+
+    printf("worker threads, producer coroutines, consumer coroutines, messages, throughput [msg/s]\n");
+    measure(2, 1, 10, numMessages);
+    measure(2, 10, 1000, numMessages/10);
+    measure(2, 100, 10000, numMessages/100);
+    measure(4, 100, 10000, numMessages/100);
+
+    return EXIT_SUCCESS;
+}
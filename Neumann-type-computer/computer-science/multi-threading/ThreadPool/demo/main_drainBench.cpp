@@ -0,0 +1,48 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include "../include/MultiThreadQueue.hpp"
+#include "../include/ThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief pending task which is never run
+ */
+class PendingTask : public Executable {
+    public:
+        const char *getDescriptionString() override {return "PendingTask";}
+        void run(ThreadInfo) override {}
+};
+
+/**
+ * @brief Fill a queue with `depth` tasks, abort them and print the time spent in `drain` (under the queue lock) and the time to destroy the drained tasks (outside the lock).
+ *
+ * @param[in] depth the number of the pending tasks
+ */
+static void measure(size_t depth) {
+    MultiThreadQueue<std::shared_ptr<Executable>> queue(depth);
+    for (size_t i=0; i<depth; ++i) {
+        queue.push(std::make_shared<PendingTask>());
+    }
+    queue.closeInlet();
+
+    const auto t0 = Clock::now();
+    auto drained = queue.drain();
+    const auto t1 = Clock::now();
+    const size_t numDrained = drained.size();
+    drained.clear();
+    const auto t2 = Clock::now();
+
+    printf("%zu, %zu, %.2f, %.2f\n", depth, numDrained, std::chrono::duration<double, std::micro>(t1 - t0).count(), std::chrono::duration<double, std::micro>(t2 - t1).count());
+}
+
+int main() {
+    printf("queue depth, drained tasks, drain (lock held) [us], destruction (lock not held) [us]\n");
+    for (size_t depth = 1000; depth <= 1000000; depth *= 10) {
+        measure(depth);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "../include/MultiThreadQueue.hpp"
+#include "../include/QueueEventFd.hpp"
+
+using Clock = std::chrono::steady_clock;
+using MessageQueue = MultiThreadQueue<Clock::time_point>; // a message carries its push time
+
+/**
+ * @brief Push `numMessages` messages at a fixed interval, then close the queue.
+ */
+static void produce(MessageQueue &queue, size_t numMessages) {
+    for (size_t i=0; i<numMessages; ++i) {
+        queue.push(Clock::now());
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    queue.closeInlet();
+}
+
+/**
+ * @brief Print the median and the 99th percentile of the push-to-handle latencies.
+ */
+static void printLatencies(const char *label, std::vector<double> &latencies_us) {
+    std::sort(latencies_us.begin(), latencies_us.end());
+    printf("%s, %zu, %.2f, %.2f\n", label, latencies_us.size(), latencies_us[latencies_us.size()/2], latencies_us[latencies_us.size()*99/100]);
+}
+
+/**
+ * @brief The old way: a bridging thread pops the queue and forwards each message to a pipe which the epoll loop watches.
+ */
+static void measureBridged(size_t numMessages) {
+    MessageQueue queue(1024);
+    int fds[2];
+    if (pipe(fds) != 0) {return;}
+    std::thread bridge([&queue, wfd = fds[1]]{
+        Clock::time_point t;
+        while (queue.pop(t)) {
+            if (write(wfd, &t, sizeof(t)) != sizeof(t)) {break;}
+        }
+        close(wfd);
+    });
+    std::thread producer(produce, std::ref(queue), numMessages);
+
+    const int epfd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fds[0];
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fds[0], &ev);
+    std::vector<double> latencies_us;
+    latencies_us.reserve(numMessages);
+    for (;;) {
+        epoll_event events[1];
+        if (epoll_wait(epfd, events, 1, -1) <= 0) {continue;}
+        std::array<Clock::time_point, 64> batch;
+        const ssize_t n = read(fds[0], batch.data(), sizeof(batch));
+        if (n <= 0) {break;} // The bridge closed the pipe.
+        const auto now = Clock::now();
+        for (size_t i=0; i<static_cast<size_t>(n)/sizeof(Clock::time_point); ++i) {
+            latencies_us.push_back(std::chrono::duration<double, std::micro>(now - batch[i]).count());
+        }
+    }
+    producer.join();
+    bridge.join();
+    close(fds[0]);
+    close(epfd);
+    printLatencies("bridging thread + pipe", latencies_us);
+}
+
+/**
+ * @brief The new way: the epoll loop watches the eventfd of the queue and drains the queue in batches on its own thread.
+ */
+static void measureEventFd(size_t numMessages) {
+    MessageQueue queue(1024);
+    QueueEventFd<MessageQueue> queueFd(queue);
+    std::thread producer(produce, std::ref(queue), numMessages);
+
+    const int epfd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = queueFd.fd();
+    epoll_ctl(epfd, EPOLL_CTL_ADD, queueFd.fd(), &ev);
+    std::vector<double> latencies_us;
+    latencies_us.reserve(numMessages);
+    for (bool isOpen = true; isOpen;) {
+        epoll_event events[1];
+        if (epoll_wait(epfd, events, 1, -1) <= 0) {continue;}
+        queueFd.clear();
+        isOpen = !queue.isInletClosed();
+        std::array<Clock::time_point, 64> batch;
+        size_t n;
+        while ((n = queue.tryPopBulk(batch.begin(), batch.size())) > 0) {
+            const auto now = Clock::now();
+            for (size_t i=0; i<n; ++i) {
+                latencies_us.push_back(std::chrono::duration<double, std::micro>(now - batch[i]).count());
+            }
+        }
+    }
+    producer.join();
+    close(epfd);
+    printLatencies("QueueEventFd", latencies_us);
+}
+
+int main() {
+    constexpr size_t numMessages = 20000;
+
+    printf("method, messages, median latency [us], p99 latency [us]\n");
+    measureBridged(numMessages);
+    measureEventFd(numMessages);
+
+    return EXIT_SUCCESS;
+}
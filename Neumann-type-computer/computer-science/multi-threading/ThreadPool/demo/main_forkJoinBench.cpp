@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../include/TaskGroup.hpp"
+#include "../include/ThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Sort [first, last) by quicksort, sorting the two partitions in parallel with a TaskGroup down to `cutoff` elements.
+ * @details Called from pooled threads too: `TaskGroup::wait` runs pending tasks instead of blocking, so the recursion never deadlocks the pool.
+ */
+static void parallelQuickSort(ThreadPool &threadPool, int *first, int *last, ptrdiff_t cutoff) {
+    if (last - first <= cutoff) {
+        std::sort(first, last);
+        return;
+    }
+    const int pivot = *(first + (last - first)/2);
+    int *const middle1 = std::partition(first, last, [pivot](int x){return x < pivot;});
+    int *const middle2 = std::partition(middle1, last, [pivot](int x){return !(pivot < x);});
+    TaskGroup<ThreadPool> group(threadPool);
+    group.run([&threadPool, first, middle1, cutoff]{parallelQuickSort(threadPool, first, middle1, cutoff);});
+    parallelQuickSort(threadPool, middle2, last, cutoff);
+    group.wait();
+}
+
+int main() {
+    constexpr size_t numElems = 1 << 22;
+    constexpr ptrdiff_t cutoff = 1 << 12;
+    constexpr size_t numReps = 5;
+    const unsigned int numCores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<int> original(numElems);
+    std::mt19937 rng(1);
+    for (int &x : original) {
+        x = static_cast<int>(rng());
+    }
+    std::vector<int> data;
+
+    double sequential_ms = 0;
+    for (size_t r=0; r<numReps; ++r) {
+        data = original;
+        const auto startTime = Clock::now();
+        std::sort(data.begin(), data.end());
+        sequential_ms += std::chrono::duration<double, std::milli>(Clock::now() - startTime).count()/numReps;
+    }
+    printf("std::sort: %.1f ms\n", sequential_ms);
+
+    printf("threads, TaskGroup quicksort from the main thread [ms], TaskGroup quicksort from a pooled thread [ms]\n");
+    for (unsigned int numThreads=1; ; numThreads*=2) {
+        numThreads = std::min(numThreads, numCores);
+        ThreadPool threadPool(numThreads, 1024);
+        double fromMain_ms = 0, fromPool_ms = 0;
+        for (size_t r=0; r<numReps; ++r) {
+            data = original;
+            auto startTime = Clock::now();
+            parallelQuickSort(threadPool, data.data(), data.data() + numElems, cutoff);
+            fromMain_ms += std::chrono::duration<double, std::milli>(Clock::now() - startTime).count()/numReps;
+            if (!std::is_sorted(data.begin(), data.end())) {printf("not sorted\n");}
+
+            /* The whole recursion inside the pool, which deadlocks with blocking joins once every pooled thread waits. */
+            data = original;
+            startTime = Clock::now();
+            threadPool.submit([&]{parallelQuickSort(threadPool, data.data(), data.data() + numElems, cutoff);}).get();
+            fromPool_ms += std::chrono::duration<double, std::milli>(Clock::now() - startTime).count()/numReps;
+            if (!std::is_sorted(data.begin(), data.end())) {printf("not sorted\n");}
+        }
+        printf("%u, %.1f, %.1f\n", numThreads, fromMain_ms, fromPool_ms);
+        threadPool.closeInlet();
+        threadPool.join();
+        if (numThreads == numCores) {
+            break;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
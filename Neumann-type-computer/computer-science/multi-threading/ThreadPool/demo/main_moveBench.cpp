@@ -0,0 +1,107 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+#include "../include/MultiThreadQueue.hpp"
+#include "../include/ThreadPool.hpp"
+
+static std::atomic<size_t> gNumAllocs{0}; // the number of heap allocations since the program started
+
+void *operator new(size_t size) {
+    gNumAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {std::free(ptr);}
+void operator delete(void *ptr, size_t) noexcept {std::free(ptr);}
+
+/**
+ * @brief an empty task
+ */
+class NopTask: public Executable {
+    public:
+        const char *getDescriptionString() override {return "NopTask";}
+        void run(ThreadInfo) override {}
+};
+
+/**
+ * @brief std::shared_ptr<Executable> wrapper which counts the copies, i.e. the atomic reference count increments
+ */
+struct CountedPtr {
+    static inline std::atomic<size_t> numCopies{0};
+    std::shared_ptr<Executable> ptr;
+
+    CountedPtr() = default;
+    explicit CountedPtr(std::shared_ptr<Executable> p) : ptr(std::move(p)) {}
+    CountedPtr(const CountedPtr &other) : ptr(other.ptr) {numCopies.fetch_add(1, std::memory_order_relaxed);}
+    CountedPtr(CountedPtr &&other) = default;
+    CountedPtr &operator=(const CountedPtr &other) {ptr = other.ptr; numCopies.fetch_add(1, std::memory_order_relaxed); return *this;}
+    CountedPtr &operator=(CountedPtr &&other) = default;
+};
+
+enum class PushMode {COPY, MOVE, EMPLACE};
+
+/**
+ * @brief Pass `numTasks` tasks through a `MultiThreadQueue` in the caller thread and print the copies and allocations per task.
+ *
+ * @param[in] label the name of the measured path
+ * @param[in] mode how tasks are put into the queue
+ * @param[in] numTasks the number of the tasks
+ */
+void measure(const char *label, PushMode mode, size_t numTasks) {
+    constexpr size_t queueDepth = 64;
+    MultiThreadQueue<CountedPtr> queue(queueDepth);
+    CountedPtr popped;
+
+    const size_t numCopies0 = CountedPtr::numCopies.load();
+    const size_t numAllocs0 = gNumAllocs.load();
+    for (size_t i=0; i<numTasks; ++i) {
+        switch (mode) {
+            case PushMode::COPY: {
+                const CountedPtr task(std::make_shared<NopTask>());
+                queue.push(task);
+                break;
+            }
+            case PushMode::MOVE: {
+                CountedPtr task(std::make_shared<NopTask>());
+                queue.push(std::move(task));
+                break;
+            }
+            case PushMode::EMPLACE:
+                queue.emplace(std::make_shared<NopTask>());
+                break;
+        }
+        queue.pop(popped);
+    }
+    const double copiesPerTask = static_cast<double>(CountedPtr::numCopies.load() - numCopies0)/numTasks;
+    const double allocsPerTask = static_cast<double>(gNumAllocs.load() - numAllocs0)/numTasks;
+    printf("%s, %.3f, %.3f\n", label, copiesPerTask, allocsPerTask);
+}
+
+int main() {
+    constexpr size_t numTasks = 100000;
+
+    printf("path, refcount increments per task, heap allocations per task\n");
+    measure("push(const T&)", PushMode::COPY, numTasks);
+    measure("push(T&&)", PushMode::MOVE, numTasks);
+    measure("emplace", PushMode::EMPLACE, numTasks);
+
+    /* Whole thread pool path. The allocations include the one for the task itself (std::make_shared). */
+    {
+        ThreadPool threadPool(2, 64);
+        const size_t numAllocs0 = gNumAllocs.load();
+        for (size_t i=0; i<numTasks; ++i) {
+            threadPool.emplaceExecutable<NopTask>();
+        }
+        threadPool.closeInlet();
+        threadPool.join();
+        printf("ThreadPool::emplaceExecutable, -, %.3f\n", static_cast<double>(gNumAllocs.load() - numAllocs0)/numTasks);
+    }
+
+    return EXIT_SUCCESS;
+}
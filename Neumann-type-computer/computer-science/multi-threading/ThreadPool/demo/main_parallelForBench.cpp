@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/ThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief per-sample work
+ */
+static float process(float x) {
+    return std::sqrt(std::fabs(std::sin(x)*std::cos(x))) + 1.0f;
+}
+
+/**
+ * @brief hand-written task which processes one fixed chunk of samples, the old way to split a loop
+ */
+class ChunkTask : public Executable {
+    private:
+        const float *const m_in;
+        float *const m_out;
+        const size_t m_begin, m_end;
+        std::atomic<size_t> &m_numDone;
+
+    public:
+        ChunkTask(const float *in, float *out, size_t begin, size_t end, std::atomic<size_t> &numDone) : m_in(in), m_out(out), m_begin(begin), m_end(end), m_numDone(numDone) {}
+
+        const char *getDescriptionString() override {return "ChunkTask";}
+
+        void run(ThreadInfo) override {
+            for (size_t i=m_begin; i<m_end; ++i) {
+                m_out[i] = process(m_in[i]);
+            }
+            m_numDone.fetch_add(1, std::memory_order_release);
+        }
+};
+
+/**
+ * @brief Measure the time of one pass over `in` [us], averaged over `numReps` passes.
+ */
+template <typename T_func>
+static double measure(size_t numReps, T_func &&func) {
+    func(); // warm up
+    const auto startTime = Clock::now();
+    for (size_t r=0; r<numReps; ++r) {
+        func();
+    }
+    return std::chrono::duration<double, std::micro>(Clock::now() - startTime).count()/numReps;
+}
+
+int main() {
+    constexpr size_t numSamples = 1 << 20;
+    constexpr size_t numReps = 20;
+    const unsigned int numCores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<float> in(numSamples), out(numSamples);
+    for (size_t i=0; i<numSamples; ++i) {
+        in[i] = static_cast<float>(i)*1e-3f;
+    }
+
+    const double sequential_us = measure(numReps, [&]{
+        for (size_t i=0; i<numSamples; ++i) {
+            out[i] = process(in[i]);
+        }
+    });
+    printf("sequential loop: %.0f us\n", sequential_us);
+
+    printf("threads, chunk tasks [us], parallelFor [us], parallelReduce [us], deterministic parallelReduce [us]\n");
+    for (unsigned int numThreads=1; ; numThreads*=2) {
+        numThreads = std::min(numThreads, numCores);
+        ThreadPool threadPool(numThreads, 1024);
+
+        /* one task per thread, waited for by polling a counter */
+        const double chunk_us = measure(numReps, [&]{
+            std::atomic<size_t> numDone{0};
+            const size_t chunkSize = (numSamples + numThreads - 1)/numThreads;
+            for (unsigned int t=0; t<numThreads; ++t) {
+                threadPool.emplaceExecutable<ChunkTask>(in.data(), out.data(), t*chunkSize, std::min(numSamples, (t + 1)*chunkSize), numDone);
+            }
+            while (numDone.load(std::memory_order_acquire) < numThreads) {
+                std::this_thread::yield();
+            }
+        });
+
+        const double parallelFor_us = measure(numReps, [&]{
+            threadPool.parallelFor(IndexRange{0, numSamples}, [&](size_t i){out[i] = process(in[i]);});
+        });
+
+        const auto body = [&](IndexRange r){double sum = 0; for (size_t i=r.begin; i<r.end; ++i) {sum += process(in[i]);} return sum;};
+        const auto plus = [](double a, double b){return a + b;};
+        const double reduce_us = measure(numReps, [&]{
+            threadPool.parallelReduce(IndexRange{0, numSamples}, 0.0, body, plus);
+        });
+        ParallelOptions deterministic;
+        deterministic.isDeterministic = true;
+        const double reduceDet_us = measure(numReps, [&]{
+            threadPool.parallelReduce(IndexRange{0, numSamples}, 0.0, body, plus, deterministic);
+        });
+
+        printf("%u, %.0f, %.0f, %.0f, %.0f\n", numThreads, chunk_us, parallelFor_us, reduce_us, reduceDet_us);
+        threadPool.closeInlet();
+        threadPool.join();
+        if (numThreads == numCores) {
+            break;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
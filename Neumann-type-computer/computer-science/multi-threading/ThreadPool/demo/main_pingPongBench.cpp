@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "../include/MultiThreadQueue.hpp"
+
+/**
+ * @brief Bounce a token between two threads through two queues and print the median and p99 round-trip latency.
+ *
+ * @param[in] label the name of the wait strategy
+ * @param[in] waitStrategy the wait strategy of both queues
+ * @param[in] numRoundTrips the number of the round trips
+ */
+void measure(const char *label, WaitStrategy waitStrategy, size_t numRoundTrips) {
+    MultiThreadQueue<unsigned int> mtq_ping(1, waitStrategy);
+    MultiThreadQueue<unsigned int> mtq_pong(1, waitStrategy);
+    std::vector<double> latencies_ns(numRoundTrips);
+
+    std::thread th_echo([&mtq_ping, &mtq_pong]{
+        unsigned int token;
+        while (mtq_ping.pop(token)) {
+            mtq_pong.push(token);
+        }
+    });
+    for (size_t i=0; i<numRoundTrips; ++i) {
+        unsigned int token = static_cast<unsigned int>(i);
+        const auto t0 = std::chrono::steady_clock::now();
+        mtq_ping.push(token);
+        mtq_pong.pop(token);
+        const std::chrono::duration<double, std::nano> latency = std::chrono::steady_clock::now() - t0;
+        latencies_ns[i] = latency.count();
+    }
+    mtq_ping.closeInlet();
+    th_echo.join();
+
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    printf("%s, %.0f, %.0f\n", label, latencies_ns[numRoundTrips/2], latencies_ns[numRoundTrips*99/100]);
+}
+
+int main() {
+    constexpr size_t numRoundTrips = 100000;
+
+    printf("wait strategy, median round trip [ns], p99 round trip [ns]\n");
+    measure("BLOCK", WaitStrategy::BLOCK, numRoundTrips);
+    measure("SPIN_THEN_PARK", WaitStrategy::SPIN_THEN_PARK, numRoundTrips);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../include/TaskGroup.hpp"
+#include "../include/ThreadPool.hpp"
+#include "../include/WorkStealingThreadPool.hpp"
+
+static int gNumFailures = 0;
+
+static void check(bool isOk, const char *what) {
+    printf("%s: %s\n", isOk ? "OK" : "NG", what);
+    if (!isOk) {
+        ++gNumFailures;
+    }
+}
+
+/**
+ * @brief Check if `future.get()` throws `std::future_error` with `std::future_errc::broken_promise`.
+ */
+template <typename T_result>
+static bool isBrokenPromise(TaskFuture<T_result> &future) {
+    try {
+        future.get();
+    } catch (const std::future_error &e) {
+        return e.code() == std::future_errc::broken_promise;
+    }
+    return false;
+}
+
+/**
+ * @brief A submitted task discarded from the queue without having run reports `broken_promise` instead of blocking `get` forever.
+ */
+static void testDiscardedSubmit() {
+    ThreadPool threadPool(1, 16);
+    std::atomic<bool> isStarted{false}, isReleased{false};
+    threadPool.post([&]{
+        isStarted.store(true);
+        while (!isReleased.load()) {std::this_thread::yield();}
+    });
+    while (!isStarted.load()) {std::this_thread::yield();} // The pooled thread is busy, so the tasks below stay queued.
+
+    TaskFuture<int> popped = threadPool.submit([]{return 1;});
+    threadPool.popAllExecutables();
+    check(isBrokenPromise(popped), "submit, then popAllExecutables: get throws broken_promise");
+
+    TaskFuture<void> drained = threadPool.submit([]{});
+    threadPool.drainExecutables().clear();
+    check(isBrokenPromise(drained), "submit, then drainExecutables and drop them: get throws broken_promise");
+
+    TaskFuture<int> kept = threadPool.submit([]{return 2;});
+    for (const auto &exe : threadPool.drainExecutables()) {
+        exe->run(ThreadInfo{.threadId=0});
+    }
+    check(kept.get() == 2, "submit, then drainExecutables and run them: get returns the result");
+
+    isReleased.store(true);
+    threadPool.closeInlet();
+    threadPool.join();
+}
+
+/**
+ * @brief argument whose copy throws
+ */
+struct ThrowingCopy {
+    ThrowingCopy() = default;
+    ThrowingCopy(const ThrowingCopy &) {throw std::runtime_error("copy");}
+};
+
+/**
+ * @brief A `TaskGroup::run` which throws while storing its task leaves the group as it was, so `wait` returns.
+ */
+static void testTaskGroupThrowingRun() {
+    ThreadPool threadPool(1, 16);
+    int numRun = 0;
+    {
+        TaskGroup<ThreadPool> group(threadPool);
+        const ThrowingCopy arg;
+        bool isThrown = false;
+        try {
+            group.run([](const ThrowingCopy &){}, arg);
+        } catch (const std::runtime_error &) {
+            isThrown = true;
+        }
+        check(isThrown, "TaskGroup::run with a throwing argument copy throws");
+        group.run([&numRun]{++numRun;});
+        group.wait();
+    }
+    check(numRun == 1, "then wait returns after the other task has run");
+    threadPool.closeInlet();
+    threadPool.join();
+}
+
+/**
+ * @brief task which pushes `numChildren` tasks, each pushing one more, from inside the pool
+ */
+class Spawner: public Executable {
+    private:
+        WorkStealingThreadPool &m_pool;
+        std::atomic<size_t> &m_numRun;
+        const size_t m_numChildren;
+
+    public:
+        Spawner(WorkStealingThreadPool &pool, std::atomic<size_t> &numRun, size_t numChildren) : m_pool(pool), m_numRun(numRun), m_numChildren(numChildren) {}
+
+        const char *getDescriptionString() override {return "Spawner";}
+
+        void run(ThreadInfo) override {
+            for (size_t i=0; i<m_numChildren; ++i) {
+                m_pool.pushExecutable(std::make_shared<Spawner>(m_pool, m_numRun, (m_numChildren > 1) ? 1 : 0));
+            }
+            m_numRun.fetch_add(1);
+        }
+};
+
+/**
+ * @brief Nested spawns overflowing the deques and a tiny injection queue do not deadlock the pooled threads, which are the only ones draining that queue.
+ */
+static void testWorkStealingNestedOverflow() {
+    constexpr size_t numRoots = 2, numChildren = 3000;
+    constexpr size_t numExpected = numRoots*(1 + 2*numChildren);
+    WorkStealingThreadPool threadPool(2, 2);
+    std::atomic<size_t> numRun{0};
+    for (size_t i=0; i<numRoots; ++i) {
+        threadPool.pushExecutable(std::make_shared<Spawner>(threadPool, numRun, numChildren));
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while ((numRun.load() < numExpected) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    check(numRun.load() == numExpected, "WorkStealingThreadPool: nested spawns with queueDepth 2 all run");
+    if (numRun.load() != numExpected) {
+        printf("%d failure(s)\n", gNumFailures);
+        fflush(stdout);
+        std::_Exit(EXIT_FAILURE); // The pooled threads are deadlocked and cannot be joined.
+    }
+    threadPool.closeInlet();
+    threadPool.join();
+}
+
+/**
+ * @brief task which counts its runs
+ */
+class Counter: public Executable {
+    private:
+        std::atomic<size_t> &m_numRun;
+
+    public:
+        explicit Counter(std::atomic<size_t> &numRun) : m_numRun(numRun) {}
+
+        const char *getDescriptionString() override {return "Counter";}
+        void run(ThreadInfo) override {m_numRun.fetch_add(1);}
+};
+
+/**
+ * @brief Every task accepted by `WorkStealingThreadPool::pushExecutable` from outside the pool runs, even if `closeInlet` races the pushes.
+ */
+static void testWorkStealingCloseRace() {
+    constexpr int numRaces = 200;
+    constexpr int numPushers = 3;
+    int numLost = 0;
+    for (int race=0; race<numRaces; ++race) {
+        WorkStealingThreadPool threadPool(2, 2); // The pushers mostly wait for room in the tiny injection queue while it is closed.
+        std::atomic<size_t> numAccepted{0}, numRun{0};
+        std::vector<std::thread> pushers;
+        for (int i=0; i<numPushers; ++i) {
+            pushers.emplace_back([&]{
+                while (threadPool.pushExecutable(std::make_shared<Counter>(numRun))) {
+                    numAccepted.fetch_add(1);
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(race % 20));
+        threadPool.closeInlet();
+        for (std::thread &pusher : pushers) {
+            pusher.join();
+        }
+        threadPool.join();
+        if (numRun.load() != numAccepted.load()) {
+            ++numLost;
+        }
+    }
+    check(numLost == 0, "WorkStealingThreadPool: closeInlet racing outside pushes, every accepted task runs");
+}
+
+int main() {
+    testDiscardedSubmit();
+    testWorkStealingNestedOverflow();
+    testTaskGroupThrowingRun();
+    testWorkStealingCloseRace();
+    printf("%d failure(s)\n", gNumFailures);
+    return (gNumFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
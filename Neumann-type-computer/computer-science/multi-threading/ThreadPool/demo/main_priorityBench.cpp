@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../include/ThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Spin for `duration` as a CPU-bound task would.
+ */
+static void busyWork(std::chrono::microseconds duration) {
+    const auto endTime = Clock::now() + duration;
+    while (Clock::now() < endTime) {}
+}
+
+/**
+ * @brief low-priority bulk work
+ */
+class BulkTask : public Executable {
+    public:
+        const char *getDescriptionString() override {return "BulkTask";}
+        void run(ThreadInfo) override {busyWork(std::chrono::microseconds(20));}
+};
+
+/**
+ * @brief high-priority control task which records the time from its push to its start
+ */
+class UrgentTask : public Executable {
+    private:
+        const Clock::time_point m_pushTime = Clock::now();
+        std::vector<double> &m_latencies_us;
+        std::mutex &m_mtx;
+
+    public:
+        UrgentTask(std::vector<double> &latencies_us, std::mutex &mtx) : m_latencies_us(latencies_us), m_mtx(mtx) {}
+
+        const char *getDescriptionString() override {return "UrgentTask";}
+        int getPriority() const override {return 1;}
+
+        void run(ThreadInfo) override {
+            const double latency_us = std::chrono::duration<double, std::micro>(Clock::now() - m_pushTime).count();
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_latencies_us.push_back(latency_us);
+        }
+};
+
+/**
+ * @brief Keep the pool saturated with bulk tasks, inject urgent tasks periodically and print their latencies.
+ *
+ * @tparam T_queuePolicy the queue policy of the pool
+ * @param[in] label the name of the policy
+ * @param[in] numUrgentTasks the number of the urgent tasks
+ */
+template <typename T_queuePolicy>
+static void measure(const char *label, size_t numUrgentTasks) {
+    const unsigned int numWorkers = std::max(2u, std::thread::hardware_concurrency());
+    constexpr unsigned int queueDepth = 256;
+    BasicThreadPool<T_queuePolicy> threadPool(numWorkers, queueDepth);
+    std::vector<double> latencies_us;
+    std::mutex mtx;
+    std::atomic<bool> isLoading{true};
+
+    std::thread bulkProducer([&threadPool, &isLoading]{
+        while (isLoading.load(std::memory_order_relaxed)) {
+            threadPool.pushExecutable(std::make_shared<BulkTask>());
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Let the queue fill up.
+    for (size_t i=0; i<numUrgentTasks; ++i) {
+        threadPool.pushExecutable(std::make_shared<UrgentTask>(latencies_us, mtx));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    isLoading = false;
+    threadPool.closeInlet();
+    bulkProducer.join();
+    threadPool.join();
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    printf("%s, %zu, %.1f, %.1f\n", label, latencies_us.size(), latencies_us[latencies_us.size()/2], latencies_us[latencies_us.size()*99/100]);
+}
+
+int main() {
+    constexpr size_t numUrgentTasks = 200;
+
+    printf("queue policy, urgent tasks, median latency [us], p99 latency [us]\n");
+    measure<MutexQueuePolicy>("MutexQueuePolicy (FIFO)", numUrgentTasks);
+    measure<PriorityQueuePolicy>("PriorityQueuePolicy", numUrgentTasks);
+
+    return EXIT_SUCCESS;
+}
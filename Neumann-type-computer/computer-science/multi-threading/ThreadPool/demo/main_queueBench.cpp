@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "../include/LockFreeMultiThreadQueue.hpp"
+#include "../include/MultiThreadQueue.hpp"
+#include "../include/ShardedMultiThreadQueue.hpp"
+#include "../include/SpscMultiThreadQueue.hpp"
+
+/**
+ * @brief Measure the throughput of a queue with `numThreads` producers and `numThreads` consumers.
+ *
+ * @tparam T_queue the queue type to be measured
+ * @param[in] numThreads the number of the producer threads, and also the number of the consumer threads
+ * @param[in] numElemsPerProducer the number of the elements each producer pushes
+ * @param[in] queueDepth the capacity of the queue
+ * @return throughput in elements per second
+ */
+template <typename T_queue>
+double measureThroughput(unsigned int numThreads, unsigned int numElemsPerProducer, size_t queueDepth) {
+    T_queue queue(queueDepth);
+    std::vector<std::thread> producers, consumers;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (unsigned int i=0; i<numThreads; ++i) {
+        consumers.emplace_back([&queue]{
+            unsigned int elem;
+            while (queue.pop(elem)) {}
+        });
+    }
+    for (unsigned int i=0; i<numThreads; ++i) {
+        producers.emplace_back([&queue, numElemsPerProducer]{
+            for (unsigned int j=0; j<numElemsPerProducer; ++j) {
+                queue.push(j);
+            }
+        });
+    }
+    for (auto &th : producers) {th.join();}
+    queue.closeInlet();
+    for (auto &th : consumers) {th.join();}
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+    return static_cast<double>(numThreads)*numElemsPerProducer/elapsedTime.count();
+}
+
+int main() {
+    constexpr unsigned int numElemsPerProducer = 200000;
+    constexpr size_t queueDepth = 1024;
+    const unsigned int maxNumThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<unsigned int> threadCounts; // 1, 2, 4, ..., maxNumThreads
+    for (unsigned int n=1; n<maxNumThreads; n*=2) {threadCounts.push_back(n);}
+    threadCounts.push_back(maxNumThreads);
+
+    printf("producers x consumers, MultiThreadQueue [elem/s], LockFreeMultiThreadQueue [elem/s], ratio, ShardedMultiThreadQueue [elem/s], ratio\n");
+    for (const unsigned int n : threadCounts) {
+        const double throughput_mutex = measureThroughput<MultiThreadQueue<unsigned int>>(n, numElemsPerProducer, queueDepth);
+        const double throughput_lockFree = measureThroughput<LockFreeMultiThreadQueue<unsigned int>>(n, numElemsPerProducer, queueDepth);
+        const double throughput_sharded = measureThroughput<ShardedMultiThreadQueue<unsigned int>>(n, numElemsPerProducer, queueDepth);
+        printf("%2ux%-2u, %.3e, %.3e, %.2f, %.3e, %.2f\n", n, n, throughput_mutex, throughput_lockFree, throughput_lockFree/throughput_mutex, throughput_sharded, throughput_sharded/throughput_mutex);
+    }
+
+    /* single-producer single-consumer handoff */
+    {
+        const double throughput_mutex = measureThroughput<MultiThreadQueue<unsigned int>>(1, numElemsPerProducer, queueDepth);
+        const double throughput_spsc = measureThroughput<SpscMultiThreadQueue<unsigned int>>(1, numElemsPerProducer, queueDepth);
+        printf("\n1x1 handoff, MultiThreadQueue [elem/s], SpscMultiThreadQueue [elem/s], ratio\n");
+        printf(" 1x1 , %.3e, %.3e, %.2f\n", throughput_mutex, throughput_spsc, throughput_spsc/throughput_mutex);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../include/BroadcastQueue.hpp"
+#include "../include/LockFreeMultiThreadQueue.hpp"
+#include "../include/SpscMultiThreadQueue.hpp"
+#include "../include/MultiThreadQueue.hpp"
+
+static int gNumFailures = 0;
+
+static void check(bool isOk, const char *what) {
+    printf("%s: %s\n", isOk ? "OK" : "NG", what);
+    if (!isOk) {
+        ++gNumFailures;
+    }
+}
+
+/**
+ * @brief Busy-wait for about `n` loop iterations, to vary where a racing call lands.
+ */
+static void spin(int n) {
+    for (volatile int i=0; i<n; i=i+1) {}
+}
+
+/**
+ * @brief element whose constructor throws for a negative value
+ */
+struct Fragile {
+    int value = 0;
+
+    Fragile() = default;
+    explicit Fragile(int v) : value(v) {
+        if (v < 0) {
+            throw std::runtime_error("negative");
+        }
+    }
+};
+
+/**
+ * @brief A `claim` whose constructor throws claims nothing, so the closed queue still drains.
+ */
+static void testThrowingClaim() {
+    MultiThreadQueue<Fragile, RingStoragePolicy> queue(4);
+    bool isThrown = false;
+    try {
+        queue.claim(-1);
+    } catch (const std::runtime_error &) {
+        isThrown = true;
+    }
+    check(isThrown, "claim with a throwing constructor throws");
+    queue.commit(queue.claim(5));
+    queue.closeInlet();
+    Fragile elem;
+    const bool isPopped = queue.pop(elem);
+    check(isPopped && (elem.value == 5), "the committed element is popped");
+    check(!queue.pop(elem), "then pop returns false instead of waiting for the failed claim");
+}
+
+/**
+ * @brief A `LockFreeMultiThreadQueue` of capacity 1 holds one element: the second push fails instead of overwriting the first, and popping does not spin forever.
+ */
+static void testLockFreeCapacityOne() {
+    LockFreeMultiThreadQueue<int> queue(1);
+    std::atomic<bool> isDone{false};
+    bool isFirstPushed = false, isSecondPushed = true, isPopped = false, isPoppedAgain = true;
+    int popped = 0;
+    std::thread thread([&]{
+        int first = 1, second = 2;
+        isFirstPushed = queue.tryPush(first);
+        isSecondPushed = queue.tryPush(second);
+        isPopped = queue.tryPop(popped);
+        isPoppedAgain = queue.tryPop(popped);
+        isDone.store(true);
+    });
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!isDone.load() && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    check(isDone.load(), "capacity 1: tryPush, tryPush, tryPop, tryPop return");
+    if (!isDone.load()) {
+        printf("%d failure(s)\n", gNumFailures);
+        fflush(stdout);
+        std::_Exit(EXIT_FAILURE); // The thread spins in the queue and cannot be joined.
+    }
+    thread.join();
+    check(isFirstPushed, "capacity 1: the first tryPush succeeds");
+    check(!isSecondPushed, "capacity 1: the second tryPush fails");
+    check(isPopped && (popped == 1), "capacity 1: tryPop returns the first element");
+    check(!isPoppedAgain, "capacity 1: then tryPop finds the queue empty");
+}
+
+/**
+ * @brief Under `OverflowPolicy::DROP_OLDEST`, a push into a full ring whose oldest slot is borrowed drops exactly one element, the new one, since dropping a visible element would free no slot.
+ */
+static void testDropOldestWithBorrowedSlot() {
+    MultiThreadQueue<int, RingStoragePolicy> queue(2, WaitStrategy::BLOCK, OverflowPolicy::DROP_OLDEST);
+    queue.push(1);
+    queue.push(2);
+    int *const borrowed = queue.borrow();
+    check((borrowed != nullptr) && (*borrowed == 1), "DROP_OLDEST: borrow returns the oldest element");
+    check(!queue.push(3), "DROP_OLDEST: push into the full queue with a borrowed slot drops the new element");
+    check(queue.numDroppedElements() == 1, "DROP_OLDEST: exactly one element is dropped");
+    int popped = 0;
+    check((queue.tryPop(popped) == QueueOpStatus::SUCCESS) && (popped == 2), "DROP_OLDEST: the visible element is kept");
+    queue.release(borrowed);
+
+    /* Without a borrowed slot, the oldest element makes room. */
+    queue.push(4);
+    queue.push(5);
+    check(queue.push(6), "DROP_OLDEST: push into the full queue without a borrowed slot succeeds");
+    check(queue.numDroppedElements() == 2, "DROP_OLDEST: the oldest element is dropped");
+    check((queue.tryPop(popped) == QueueOpStatus::SUCCESS) && (popped == 5), "DROP_OLDEST: the second oldest element is popped first");
+}
+
+/**
+ * @brief element whose move yields the CPU, which widens the window between a push checking the inlet and publishing the element
+ */
+struct SlowMove {
+    SlowMove() = default;
+    SlowMove(SlowMove &&) noexcept {std::this_thread::yield();}
+    SlowMove &operator=(SlowMove &&) noexcept {return *this;}
+};
+
+/**
+ * @brief A `SpscMultiThreadQueue::push` racing `closeInlet` is either rejected or popped: the consumer does not give up on the closed queue while the last element lands.
+ */
+static void testSpscCloseRace() {
+    constexpr int numRaces = 2000;
+    int numLost = 0;
+    for (int race=0; race<numRaces; ++race) {
+        SpscMultiThreadQueue<SlowMove> queue(4);
+        long numPushed = 0, numPopped = 0;
+        std::thread producer([&]{
+            while (queue.push(SlowMove())) {++numPushed;}
+        });
+        std::thread closer([&]{
+            spin((race % 50)*20);
+            queue.closeInlet();
+        });
+        SlowMove elem;
+        while (queue.pop(elem)) {++numPopped;}
+        producer.join();
+        closer.join();
+        if (numPopped != numPushed) {
+            ++numLost;
+        }
+    }
+    check(numLost == 0, "SpscMultiThreadQueue: closeInlet racing push, every accepted element is popped");
+}
+
+/**
+ * @brief A `BroadcastQueue::push` racing `closeInlet` is either rejected or read by every consumer.
+ */
+static void testBroadcastCloseRace() {
+    constexpr int numRaces = 2000;
+    constexpr size_t numConsumers = 2;
+    int numLost = 0;
+    for (int race=0; race<numRaces; ++race) {
+        BroadcastQueue<SlowMove> queue(4, numConsumers);
+        long numPushed = 0;
+        long numRead[numConsumers] = {};
+        std::thread producer([&]{
+            while (queue.push(SlowMove())) {++numPushed;}
+        });
+        std::thread closer([&]{
+            spin((race % 50)*20);
+            queue.closeInlet();
+        });
+        std::vector<std::thread> consumers;
+        for (size_t c=0; c<numConsumers; ++c) {
+            consumers.emplace_back([&, c]{
+                while (queue.borrow(c) != nullptr) {
+                    ++numRead[c];
+                    queue.release(c);
+                }
+            });
+        }
+        producer.join();
+        closer.join();
+        for (std::thread &consumer : consumers) {
+            consumer.join();
+        }
+        for (size_t c=0; c<numConsumers; ++c) {
+            if (numRead[c] != numPushed) {
+                ++numLost;
+            }
+        }
+    }
+    check(numLost == 0, "BroadcastQueue: closeInlet racing push, every consumer reads every accepted element");
+}
+
+int main() {
+    testThrowingClaim();
+    testLockFreeCapacityOne();
+    testDropOldestWithBorrowedSlot();
+    testSpscCloseRace();
+    testBroadcastCloseRace();
+    printf("%d failure(s)\n", gNumFailures);
+    return (gNumFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
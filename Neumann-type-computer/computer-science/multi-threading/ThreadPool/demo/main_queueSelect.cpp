@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/MultiThreadQueue.hpp"
+#include "../include/QueueSelector.hpp"
+
+using ChannelQueue = MultiThreadQueue<unsigned int>;
+
+/**
+ * @brief Start one producer thread per channel, each of which pushes `numElemsPerChannel` elements and closes its queue.
+ */
+static std::vector<std::thread> startProducers(std::vector<std::unique_ptr<ChannelQueue>> &channels, unsigned int numElemsPerChannel) {
+    std::vector<std::thread> producers;
+    for (auto &channel : channels) {
+        producers.emplace_back([&queue = *channel, numElemsPerChannel]{
+            for (unsigned int i=0; i<numElemsPerChannel; ++i) {queue.push(i);}
+            queue.closeInlet();
+        });
+    }
+    return producers;
+}
+
+/**
+ * @brief Aggregate the channels with one bridging thread per channel, which forwards the elements into a merged queue.
+ *
+ * @return throughput in elements per second
+ */
+static double measureBridged(unsigned int numChannels, unsigned int numElemsPerChannel, size_t queueDepth) {
+    std::vector<std::unique_ptr<ChannelQueue>> channels;
+    for (unsigned int c=0; c<numChannels; ++c) {channels.push_back(std::make_unique<ChannelQueue>(queueDepth));}
+    ChannelQueue merged(queueDepth);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers = startProducers(channels, numElemsPerChannel);
+    std::vector<std::thread> bridges;
+    for (auto &channel : channels) {
+        bridges.emplace_back([&queue = *channel, &merged]{
+            unsigned int elem;
+            while (queue.pop(elem)) {merged.push(elem);}
+        });
+    }
+    std::thread closer([&bridges, &merged]{
+        for (auto &th : bridges) {th.join();}
+        merged.closeInlet();
+    });
+    unsigned long long sum = 0;
+    unsigned int elem;
+    while (merged.pop(elem)) {sum += elem;}
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    for (auto &th : producers) {th.join();}
+    closer.join();
+
+    printf("(sum %llu) ", sum);
+    return static_cast<double>(numChannels)*numElemsPerChannel/elapsedTime.count();
+}
+
+/**
+ * @brief Aggregate the channels with one thread which waits on all of them with `QueueSelector`.
+ *
+ * @return throughput in elements per second
+ */
+static double measureSelected(unsigned int numChannels, unsigned int numElemsPerChannel, size_t queueDepth) {
+    std::vector<std::unique_ptr<ChannelQueue>> channels;
+    for (unsigned int c=0; c<numChannels; ++c) {channels.push_back(std::make_unique<ChannelQueue>(queueDepth));}
+    QueueSelector selector;
+    for (auto &channel : channels) {selector.add(*channel);}
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers = startProducers(channels, numElemsPerChannel);
+    unsigned long long sum = 0;
+    for (unsigned int numOpenChannels = numChannels; numOpenChannels > 0;) {
+        const size_t i = selector.waitAny();
+        unsigned int elem;
+        QueueOpStatus status;
+        while ((status = channels[i]->tryPop(elem)) == QueueOpStatus::SUCCESS) {sum += elem;}
+        if (status == QueueOpStatus::CLOSED) {
+            selector.remove(i);
+            --numOpenChannels;
+        }
+    }
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    for (auto &th : producers) {th.join();}
+
+    printf("(sum %llu) ", sum);
+    return static_cast<double>(numChannels)*numElemsPerChannel/elapsedTime.count();
+}
+
+int main() {
+    constexpr unsigned int numChannels = 4;
+    constexpr unsigned int numElemsPerChannel = 200000;
+    constexpr size_t queueDepth = 256;
+
+    printf("%u channels, %u elements each\n", numChannels, numElemsPerChannel);
+    const double throughput_bridged = measureBridged(numChannels, numElemsPerChannel, queueDepth);
+    printf("bridging thread per channel [elem/s]: %.3e\n", throughput_bridged);
+    const double throughput_selected = measureSelected(numChannels, numElemsPerChannel, queueDepth);
+    printf("QueueSelector [elem/s]: %.3e\n", throughput_selected);
+    printf("ratio: %.2f\n", throughput_selected/throughput_bridged);
+
+    return EXIT_SUCCESS;
+}
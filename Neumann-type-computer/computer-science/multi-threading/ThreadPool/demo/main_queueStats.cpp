@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "../include/MultiThreadQueue.hpp"
+
+/**
+ * @brief Print the statistics of a queue.
+ */
+static void printStats(const QueueStatsSnapshot &stats) {
+    printf("depth %zu, peak depth %zu\n", stats.depth, stats.peakDepth);
+    printf("occupancy histogram (tenths of capacity):");
+    for (const uint64_t count : stats.occupancyHistogram) {printf(" %llu", static_cast<unsigned long long>(count));}
+    printf("\n");
+    printf("producers: %llu blocks, total %.3e s, p99 %.3e s\n", static_cast<unsigned long long>(stats.producers.numBlocks), stats.producers.total_s, stats.producers.p99_s);
+    printf("consumers: %llu blocks, total %.3e s, p99 %.3e s\n", static_cast<unsigned long long>(stats.consumers.numBlocks), stats.consumers.total_s, stats.consumers.p99_s);
+    printf("notify_one %llu, notify_all %llu\n", static_cast<unsigned long long>(stats.numNotifyOne), static_cast<unsigned long long>(stats.numNotifyAll));
+}
+
+/**
+ * @brief Stream `numElems` integers from a producer thread to a consumer thread.
+ *
+ * @tparam T_queue the queue type
+ * @param[in,out] queue the queue
+ * @param[in] numElems the number of the elements
+ * @param[in] consumerDelay time the consumer spends on each element
+ * @return throughput in elements per second
+ */
+template <typename T_queue>
+static double stream(T_queue &queue, unsigned int numElems, std::chrono::microseconds consumerDelay) {
+    const auto startTime = std::chrono::steady_clock::now();
+    std::thread consumer([&queue, consumerDelay]{
+        unsigned int elem;
+        while (queue.pop(elem)) {
+            if (consumerDelay.count() > 0) {std::this_thread::sleep_for(consumerDelay);}
+        }
+    });
+    for (unsigned int i=0; i<numElems; ++i) {
+        queue.push(i);
+    }
+    queue.closeInlet();
+    consumer.join();
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    return numElems/elapsedTime.count();
+}
+
+int main() {
+    constexpr size_t queueDepth = 64;
+
+    /* A slow consumer stalls the producer: the queue stays full and the producer blocks. */
+    {
+        MultiThreadQueue<unsigned int, DequeStoragePolicy, QueueStats> queue(queueDepth);
+        stream(queue, 2000, std::chrono::microseconds(100));
+        printf("slow consumer\n");
+        printStats(queue.stats());
+    }
+
+    /* overhead of the statistics */
+    {
+        constexpr unsigned int numElems = 2000000;
+        MultiThreadQueue<unsigned int> queue_noStats(queueDepth);
+        MultiThreadQueue<unsigned int, DequeStoragePolicy, QueueStats> queue_stats(queueDepth);
+        const double throughput_noStats = stream(queue_noStats, numElems, std::chrono::microseconds(0));
+        const double throughput_stats = stream(queue_stats, numElems, std::chrono::microseconds(0));
+        printf("\nfull speed\n");
+        printStats(queue_stats.stats());
+        printf("throughput without stats %.3e elem/s, with stats %.3e elem/s, ratio %.2f\n", throughput_noStats, throughput_stats, throughput_stats/throughput_noStats);
+    }
+
+    return EXIT_SUCCESS;
+}
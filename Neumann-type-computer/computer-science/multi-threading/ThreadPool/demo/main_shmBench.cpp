@@ -0,0 +1,140 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../include/ShmMultiThreadQueue.hpp"
+
+/**
+ * @brief message exchanged between the capture process and the processing process
+ *
+ * @tparam N the number of the samples
+ */
+template <size_t N>
+struct Message {
+    uint64_t seq;
+    std::array<float, N> samples;
+};
+
+/**
+ * @brief Write the whole buffer to a pipe.
+ */
+static bool writeAll(int fd, const void *buf, size_t size) {
+    const char *p = static_cast<const char *>(buf);
+    while (size > 0) {
+        const ssize_t n = write(fd, p, size);
+        if (n <= 0) {return false;}
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Read the whole buffer from a pipe.
+ *
+ * @retval true The buffer was filled.
+ * @retval false The pipe reached EOF (or failed).
+ */
+static bool readAll(int fd, void *buf, size_t size) {
+    char *p = static_cast<char *>(buf);
+    while (size > 0) {
+        const ssize_t n = read(fd, p, size);
+        if (n <= 0) {return false;}
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Wait for the child process and check that it received all the messages in order.
+ */
+static bool waitChild(pid_t pid) {
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS);
+}
+
+/**
+ * @brief Send `numMessages` messages from this process to a child process through a pipe.
+ *
+ * @return throughput in messages per second, or 0 on failure
+ */
+template <typename T_msg>
+static double measurePipe(uint64_t numMessages) {
+    int fds[2];
+    if (pipe(fds) != 0) {return 0;}
+    const auto startTime = std::chrono::steady_clock::now();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[1]);
+        T_msg msg;
+        uint64_t expected = 0;
+        while (readAll(fds[0], &msg, sizeof(msg))) {
+            if (msg.seq != expected++) {_exit(EXIT_FAILURE);}
+        }
+        _exit((expected == numMessages) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(fds[0]);
+    T_msg msg{};
+    for (uint64_t i=0; i<numMessages; ++i) {
+        msg.seq = i;
+        if (!writeAll(fds[1], &msg, sizeof(msg))) {break;}
+    }
+    close(fds[1]);
+    const bool isOk = waitChild(pid);
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    return isOk ? numMessages/elapsedTime.count() : 0;
+}
+
+/**
+ * @brief Send `numMessages` messages from this process to a child process through `ShmMultiThreadQueue`.
+ *
+ * @return throughput in messages per second, or 0 on failure
+ */
+template <typename T_msg>
+static double measureShm(uint64_t numMessages, size_t queueDepth) {
+    const std::string name = "/main_shmBench." + std::to_string(getpid());
+    ShmMultiThreadQueue<T_msg> queue(name, ShmOpenMode::CREATE, queueDepth);
+    const auto startTime = std::chrono::steady_clock::now();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        ShmMultiThreadQueue<T_msg> peer(name, ShmOpenMode::ATTACH); // as an unrelated process would
+        T_msg msg;
+        uint64_t expected = 0;
+        while (peer.pop(msg)) {
+            if (msg.seq != expected++) {_exit(EXIT_FAILURE);}
+        }
+        _exit((expected == numMessages) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    T_msg msg{};
+    for (uint64_t i=0; i<numMessages; ++i) {
+        msg.seq = i;
+        queue.push(msg);
+    }
+    queue.closeInlet();
+    const bool isOk = waitChild(pid);
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    return isOk ? numMessages/elapsedTime.count() : 0;
+}
+
+template <typename T_msg>
+static void compare(const char *label, uint64_t numMessages, size_t queueDepth) {
+    const double throughput_pipe = measurePipe<T_msg>(numMessages);
+    const double throughput_shm = measureShm<T_msg>(numMessages, queueDepth);
+    printf("%s, %.3e, %.3e, %.2f\n", label, throughput_pipe, throughput_shm, throughput_shm/throughput_pipe);
+}
+
+int main() {
+    constexpr uint64_t numMessages = 200000;
+    constexpr size_t queueDepth = 256;
+
+    printf("message size, pipe [msg/s], ShmMultiThreadQueue [msg/s], ratio\n");
+    compare<Message<14>>("64 B", numMessages, queueDepth);
+    compare<Message<1022>>("4 KiB", numMessages, queueDepth);
+
+    return EXIT_SUCCESS;
+}
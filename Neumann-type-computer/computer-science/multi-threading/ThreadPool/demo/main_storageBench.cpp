@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+#include "../include/MultiThreadQueue.hpp"
+
+static std::atomic<size_t> gNumAllocs{0}; // the number of heap allocations since the program started
+
+void *operator new(size_t size) {
+    gNumAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {std::free(ptr);}
+void operator delete(void *ptr, size_t) noexcept {std::free(ptr);}
+
+using Sample = std::array<float, 16>; // 64-byte sample block
+
+/**
+ * @brief Stream `numElems` samples from a producer thread to a consumer thread, and print the allocation rate and the pop latency.
+ *
+ * @tparam T_storagePolicy storage policy of the measured queue
+ * @param[in] label the name of the storage policy
+ * @param[in] numElems the number of the samples
+ * @param[in] queueDepth the capacity of the queue
+ */
+template <typename T_storagePolicy>
+void measure(const char *label, size_t numElems, size_t queueDepth) {
+    MultiThreadQueue<Sample, T_storagePolicy> queue(queueDepth);
+    std::vector<double> popLatencies_ns; // reserved beforehand, so that it does not allocate during the measurement
+    popLatencies_ns.reserve(numElems);
+
+    const size_t numAllocs0 = gNumAllocs.load();
+    const auto startTime = std::chrono::steady_clock::now();
+    std::thread consumer([&queue, &popLatencies_ns]{
+        Sample sample;
+        for (;;) {
+            const auto t0 = std::chrono::steady_clock::now();
+            if (!queue.pop(sample)) {break;}
+            const std::chrono::duration<double, std::nano> latency = std::chrono::steady_clock::now() - t0;
+            popLatencies_ns.push_back(latency.count());
+        }
+    });
+    Sample sample{};
+    for (size_t i=0; i<numElems; ++i) {
+        sample[0] = static_cast<float>(i);
+        queue.push(sample);
+    }
+    queue.closeInlet();
+    consumer.join();
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    const size_t numAllocs = gNumAllocs.load() - numAllocs0 - 1; // Exclude the allocation for the consumer thread.
+
+    std::sort(popLatencies_ns.begin(), popLatencies_ns.end());
+    const double p50 = popLatencies_ns[popLatencies_ns.size()/2];
+    const double p99 = popLatencies_ns[popLatencies_ns.size()*99/100];
+    printf("%s, %.3e, %.1f, %.1f\n", label, numAllocs/elapsedTime.count(), p50, p99);
+}
+
+int main() {
+    constexpr size_t numElems = 1000000;
+    constexpr size_t queueDepth = 256;
+
+    printf("storage, allocations [1/s], p50 pop latency [ns], p99 pop latency [ns]\n");
+    measure<DequeStoragePolicy>("DequeStorage", numElems, queueDepth);
+    measure<RingStoragePolicy>("RingStorage", numElems, queueDepth);
+
+    return EXIT_SUCCESS;
+}
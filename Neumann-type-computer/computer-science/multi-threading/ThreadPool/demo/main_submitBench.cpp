@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include "../include/ThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<size_t> gNumAllocs{0}; // the number of heap allocations since the program started
+
+void *operator new(size_t size) {
+    gNumAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {std::free(ptr);}
+void operator delete(void *ptr, size_t) noexcept {std::free(ptr);}
+
+/**
+ * @brief an empty task
+ */
+class NopTask: public Executable {
+    public:
+        const char *getDescriptionString() override {return "NopTask";}
+        void run(ThreadInfo) override {}
+};
+
+enum class SubmitMode {EXECUTABLE, POST, SUBMIT};
+
+/**
+ * @brief Run `numTasks` empty tasks on a pool and print the throughput and the heap allocations per task.
+ *
+ * @tparam T_queuePolicy the queue policy of the pool
+ * @param[in] label the name of the measured path
+ * @param[in] mode how tasks are put into the pool
+ */
+template <typename T_queuePolicy>
+static void measure(const char *label, SubmitMode mode, unsigned int numWorkers, size_t numTasks) {
+    constexpr size_t queueDepth = 1024;
+    BasicThreadPool<T_queuePolicy> threadPool(numWorkers, queueDepth);
+    TaskFuture<void> lastFuture;
+
+    const size_t numAllocs0 = gNumAllocs.load();
+    const auto startTime = Clock::now();
+    for (size_t i=0; i<numTasks; ++i) {
+        switch (mode) {
+            case SubmitMode::EXECUTABLE:
+                threadPool.template emplaceExecutable<NopTask>();
+                break;
+            case SubmitMode::POST:
+                threadPool.post([]{});
+                break;
+            case SubmitMode::SUBMIT:
+                lastFuture = threadPool.submit([]{});
+                break;
+        }
+    }
+    threadPool.finishBatch();
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - startTime).count();
+    const double allocsPerTask = static_cast<double>(gNumAllocs.load() - numAllocs0)/numTasks;
+    if (lastFuture.valid()) {lastFuture.get();}
+    threadPool.closeInlet();
+    threadPool.join();
+    printf("%s, %.3e, %.3f\n", label, numTasks/elapsed_s, allocsPerTask);
+}
+
+int main() {
+    const unsigned int numWorkers = std::max(2u, std::thread::hardware_concurrency());
+    constexpr size_t numTasks = 1 << 20;
+
+    printf("path, throughput [tasks/s], heap allocations per task\n");
+    measure<MutexQueuePolicy>("ThreadPool::emplaceExecutable", SubmitMode::EXECUTABLE, numWorkers, numTasks);
+    measure<MutexQueuePolicy>("ThreadPool::post", SubmitMode::POST, numWorkers, numTasks);
+    measure<MutexQueuePolicy>("ThreadPool::submit", SubmitMode::SUBMIT, numWorkers, numTasks);
+    measure<LockFreeQueuePolicy>("BasicThreadPool<LockFreeQueuePolicy>::emplaceExecutable", SubmitMode::EXECUTABLE, numWorkers, numTasks);
+    measure<LockFreeQueuePolicy>("BasicThreadPool<LockFreeQueuePolicy>::post", SubmitMode::POST, numWorkers, numTasks);
+    measure<LockFreeQueuePolicy>("BasicThreadPool<LockFreeQueuePolicy>::submit", SubmitMode::SUBMIT, numWorkers, numTasks);
+
+    return EXIT_SUCCESS;
+}
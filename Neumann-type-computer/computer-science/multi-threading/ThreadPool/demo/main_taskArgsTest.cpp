@@ -0,0 +1,63 @@
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include "../include/TaskGroup.hpp"
+#include "../include/ThreadPool.hpp"
+
+static int gNumFailures = 0;
+
+static void check(bool isOk, const char *what) {
+    printf("%s: %s\n", isOk ? "OK" : "NG", what);
+    if (!isOk) {
+        ++gNumFailures;
+    }
+}
+
+static void increment(int &x) {++x;}
+static void consume(std::string s) {s.clear();}
+
+int main() {
+    ThreadPool threadPool(1, 16); // one pooled thread runs the tasks in FIFO order
+
+    /* `std::ref` binds the caller's object to a reference parameter, as with `std::thread`. */
+    int counter = 0;
+    threadPool.submit(increment, std::ref(counter)).get();
+    check(counter == 1, "submit(f, std::ref(x)) with f(int &)");
+
+    counter = 0;
+    threadPool.post(increment, std::ref(counter));
+    threadPool.submit([]{}).get(); // Wait for the posted task through a later one.
+    check(counter == 1, "post(f, std::ref(x)) with f(int &)");
+
+    counter = 0;
+    check(threadPool.tryPost(increment, std::ref(counter)), "tryPost to a pool with room");
+    threadPool.submit([]{}).get();
+    check(counter == 1, "tryPost(f, std::ref(x)) with f(int &)");
+
+    /* Fork-join tasks writing partial results through `std::ref`. */
+    int partials[2] = {0, 0};
+    {
+        TaskGroup<ThreadPool> group(threadPool);
+        group.run(increment, std::ref(partials[0]));
+        group.run(increment, std::ref(partials[1]));
+        group.wait();
+    }
+    check((partials[0] == 1) && (partials[1] == 1), "TaskGroup::run(f, std::ref(x)) with f(int &)");
+
+    /* A by-value parameter gets a copy of the object referred to, which is left intact. */
+    const std::string text = "kept";
+    std::string copied = text;
+    threadPool.submit(consume, std::ref(copied)).get();
+    check(copied == text, "submit(f, std::ref(s)) with f(std::string) copies s");
+
+    /* The other arguments are decay-copied into the task, so the caller's lvalue is not moved from. */
+    std::string lvalue = text;
+    threadPool.submit(consume, lvalue).get();
+    check(lvalue == text, "submit(f, s) with an lvalue s copies s");
+
+    threadPool.closeInlet();
+    threadPool.join();
+    printf("%d failure(s)\n", gNumFailures);
+    return (gNumFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
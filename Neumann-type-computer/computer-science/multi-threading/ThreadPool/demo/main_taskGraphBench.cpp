@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "../include/TaskGraph.hpp"
+#include "../include/ThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Keep the caller thread busy for `duration_us` microseconds, standing for the processing of a stage.
+ */
+static void work(double duration_us) {
+    const auto endTime = Clock::now() + std::chrono::duration<double, std::micro>(duration_us);
+    while (Clock::now() < endTime) {}
+}
+
+/**
+ * @brief processing time of the stages of each channel [us]; the channels are unbalanced differently in every stage
+ */
+struct Workload {
+    static constexpr size_t NUM_CHANNELS = 4;
+    static constexpr double DECODE_US[NUM_CHANNELS] = {100, 300, 100, 300};
+    static constexpr double FILTER_US[NUM_CHANNELS] = {300, 100, 300, 100};
+    static constexpr double MERGE_US = 50;
+    static constexpr double WRITE_US = 50;
+};
+
+/**
+ * @brief The old way: run each stage as tasks and wait for all of them before starting the next stage.
+ *
+ * @return the end-to-end latency per frame [us]
+ */
+static double measureBarriers(ThreadPool &threadPool, size_t numFrames) {
+    const auto startTime = Clock::now();
+    for (size_t f=0; f<numFrames; ++f) {
+        std::vector<TaskFuture<void>> futures;
+        for (size_t ch=0; ch<Workload::NUM_CHANNELS; ++ch) {
+            futures.push_back(threadPool.submit([ch]{work(Workload::DECODE_US[ch]);}));
+        }
+        for (auto &future : futures) {future.get();}
+        futures.clear();
+        for (size_t ch=0; ch<Workload::NUM_CHANNELS; ++ch) {
+            futures.push_back(threadPool.submit([ch]{work(Workload::FILTER_US[ch]);}));
+        }
+        for (auto &future : futures) {future.get();}
+        threadPool.submit([]{work(Workload::MERGE_US);}).get();
+        threadPool.submit([]{work(Workload::WRITE_US);}).get();
+    }
+    return std::chrono::duration<double, std::micro>(Clock::now() - startTime).count()/numFrames;
+}
+
+/**
+ * @brief The new way: one TaskGraph built once and run per frame; the filter of a channel starts as soon as its decode has finished.
+ *
+ * @return the end-to-end latency per frame [us]
+ */
+static double measureGraph(ThreadPool &threadPool, size_t numFrames) {
+    TaskGraph graph;
+    const TaskGraph::NodeId merge = graph.addNode([]{work(Workload::MERGE_US);});
+    const TaskGraph::NodeId write = graph.addNode([]{work(Workload::WRITE_US);});
+    graph.addEdge(merge, write);
+    for (size_t ch=0; ch<Workload::NUM_CHANNELS; ++ch) {
+        const TaskGraph::NodeId decode = graph.addNode([ch]{work(Workload::DECODE_US[ch]);});
+        const TaskGraph::NodeId filter = graph.addNode([ch]{work(Workload::FILTER_US[ch]);});
+        graph.addEdge(decode, filter);
+        graph.addEdge(filter, merge);
+    }
+
+    const auto startTime = Clock::now();
+    for (size_t f=0; f<numFrames; ++f) {
+        graph.run(threadPool);
+    }
+    return std::chrono::duration<double, std::micro>(Clock::now() - startTime).count()/numFrames;
+}
+
+int main() {
+    constexpr size_t numFrames = 200;
+    const unsigned int numCores = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned int numWorkers = std::max(1u, std::min<unsigned int>(numCores, Workload::NUM_CHANNELS));
+
+    /* The caller thread of `TaskGraph::run` runs nodes too, so the graph gets one pooled thread less to use the same number of cores. */
+    ThreadPool barrierPool(numWorkers, 64);
+    ThreadPool graphPool(std::max(1u, numWorkers - 1), 64);
+
+    printf("workers, stage barriers [us/frame], TaskGraph [us/frame]\n");
+    printf("%u, %.0f, %.0f\n", numWorkers, measureBarriers(barrierPool, numFrames), measureGraph(graphPool, numFrames));
+
+    barrierPool.closeInlet();
+    graphPool.closeInlet();
+    barrierPool.join();
+    graphPool.join();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+#include <vector>
+#include "../include/MultiThreadQueue.hpp"
+
+using Clock = std::chrono::steady_clock;
+using BurstQueue = MultiThreadQueue<unsigned int, DequeStoragePolicy, QueueStats>;
+
+/**
+ * @brief Spin for `duration` as a CPU-bound handler would.
+ */
+static void busyWork(std::chrono::nanoseconds duration) {
+    const auto endTime = Clock::now() + duration;
+    while (Clock::now() < endTime) {}
+}
+
+/**
+ * @brief Push bursts of elements at intervals to consumers which pop in batches, and print the wakeup costs per element.
+ *
+ * @param[in] label the name of the configuration
+ * @param[in] watermarks the watermarks of the queue
+ */
+static void measure(const char *label, NotifyWatermarks watermarks) {
+    constexpr unsigned int numConsumers = 8;
+    constexpr unsigned int numBursts = 2000;
+    constexpr unsigned int burstSize = 64;
+    BurstQueue queue(1024, WaitStrategy::BLOCK, OverflowPolicy::BLOCK, watermarks);
+
+    const auto startTime = Clock::now();
+    std::vector<std::thread> consumers;
+    for (unsigned int i=0; i<numConsumers; ++i) {
+        consumers.emplace_back([&queue]{
+            std::array<unsigned int, 16> batch;
+            size_t n;
+            while ((n = queue.popBulk(batch.begin(), batch.size())) > 0) {
+                busyWork(std::chrono::nanoseconds(200*n));
+            }
+        });
+    }
+    for (unsigned int b=0; b<numBursts; ++b) {
+        for (unsigned int i=0; i<burstSize; ++i) {
+            queue.push(i);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    queue.closeInlet();
+    for (auto &th : consumers) {th.join();}
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    const QueueStatsSnapshot stats = queue.stats();
+    const double numElems = static_cast<double>(numBursts)*burstSize;
+    printf("%s, %.3f, %.3f, %.3f, %.3f\n", label, (stats.numNotifyOne + stats.numNotifyAll)/numElems, stats.consumers.numBlocks/numElems, elapsed_s, stats.consumers.total_s);
+}
+
+int main() {
+    constexpr size_t noHighWatermark = std::numeric_limits<size_t>::max();
+
+    printf("watermarks, notifies per element, consumer blocks per element, elapsed time [s], consumer blocked time [s]\n");
+    measure("low 1 (default)", NotifyWatermarks{1, noHighWatermark});
+    measure("low 16", NotifyWatermarks{16, noHighWatermark});
+    measure("low 16, high 48", NotifyWatermarks{16, 48});
+    measure("low 64", NotifyWatermarks{64, noHighWatermark});
+
+    return EXIT_SUCCESS;
+}
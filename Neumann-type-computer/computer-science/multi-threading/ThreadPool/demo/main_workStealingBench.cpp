@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/ThreadPool.hpp"
+#include "../include/WorkStealingThreadPool.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief short task which only counts itself
+ */
+class LeafTask : public Executable {
+    private:
+        std::atomic<size_t> &m_count;
+
+    public:
+        explicit LeafTask(std::atomic<size_t> &count) : m_count(count) {}
+
+        const char *getDescriptionString() override {return "LeafTask";}
+        void run(ThreadInfo) override {m_count.fetch_add(1, std::memory_order_relaxed);}
+};
+
+/**
+ * @brief task which pushes `numChildren` leaf tasks to the pool it runs on
+ *
+ * @tparam T_pool the pool type
+ */
+template <typename T_pool>
+class SpawnTask : public Executable {
+    private:
+        T_pool &m_pool;
+        std::atomic<size_t> &m_count;
+        const size_t m_numChildren;
+
+    public:
+        SpawnTask(T_pool &pool, std::atomic<size_t> &count, size_t numChildren) : m_pool(pool), m_count(count), m_numChildren(numChildren) {}
+
+        const char *getDescriptionString() override {return "SpawnTask";}
+
+        void run(ThreadInfo) override {
+            for (size_t i=0; i<m_numChildren; ++i) {
+                m_pool.template emplaceExecutable<LeafTask>(m_count);
+            }
+        }
+};
+
+/**
+ * @brief Run `numTasks` leaf tasks, pushed either by the main thread (flat) or by spawning tasks running in the pool (nested), and return the throughput.
+ *
+ * @tparam T_pool the pool type
+ * @return tasks per second
+ */
+template <typename T_pool>
+static double measure(unsigned int numThreads, size_t numTasks, bool isNested) {
+    constexpr size_t numChildren = 256;
+    std::atomic<size_t> count{0};
+    T_pool threadPool(numThreads, numTasks); // deep enough for all the tasks, otherwise a pooled thread pushing children can block on the full queue which only the pooled threads drain
+    const auto startTime = Clock::now();
+    if (isNested) {
+        for (size_t i=0; i<numTasks/numChildren; ++i) {
+            threadPool.template emplaceExecutable<SpawnTask<T_pool>>(threadPool, count, numChildren);
+        }
+    } else {
+        for (size_t i=0; i<numTasks; ++i) {
+            threadPool.template emplaceExecutable<LeafTask>(count);
+        }
+    }
+    while (count.load(std::memory_order_relaxed) < numTasks) {
+        std::this_thread::yield();
+    }
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - startTime).count();
+    threadPool.closeInlet();
+    threadPool.join();
+    return numTasks/elapsed_s;
+}
+
+int main() {
+    constexpr size_t numTasks = 1 << 18;
+    const unsigned int numCores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int n=1; n<numCores; n*=2) {threadCounts.push_back(n);}
+    threadCounts.push_back(numCores);
+
+    printf("threads, ThreadPool flat [tasks/s], WorkStealingThreadPool flat [tasks/s], ThreadPool nested [tasks/s], WorkStealingThreadPool nested [tasks/s]\n");
+    for (const unsigned int n : threadCounts) {
+        printf("%u, %.3e, %.3e, %.3e, %.3e\n", n,
+            measure<ThreadPool>(n, numTasks, false), measure<WorkStealingThreadPool>(n, numTasks, false),
+            measure<ThreadPool>(n, numTasks, true), measure<WorkStealingThreadPool>(n, numTasks, true));
+    }
+
+    return EXIT_SUCCESS;
+}
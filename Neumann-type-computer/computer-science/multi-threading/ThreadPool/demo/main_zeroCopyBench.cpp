@@ -0,0 +1,96 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "../include/MultiThreadQueue.hpp"
+
+using SampleBlock = std::array<float, 16384>; // 64 KiB sample block
+using BlockQueue = MultiThreadQueue<SampleBlock, RingStoragePolicy>;
+
+/**
+ * @brief Fill a sample block as a signal source would.
+ */
+static void fillBlock(SampleBlock &block, size_t seq) {
+    for (size_t i=0; i<block.size(); ++i) {
+        block[i] = static_cast<float>(seq + i);
+    }
+}
+
+/**
+ * @brief Sum a sample block as a signal sink would.
+ */
+static double sumBlock(const SampleBlock &block) {
+    double sum = 0;
+    for (const float x : block) {sum += x;}
+    return sum;
+}
+
+/**
+ * @brief Stream blocks which are built in a local buffer, pushed (copied) into the queue, and popped (copied) out of it.
+ *
+ * @return throughput in blocks per second
+ */
+static double measureCopy(size_t numBlocks, size_t queueDepth) {
+    BlockQueue queue(queueDepth);
+    double checksum = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+    std::thread consumer([&queue, &checksum]{
+        const auto block = std::make_unique<SampleBlock>();
+        while (queue.pop(*block)) {
+            checksum += sumBlock(*block);
+        }
+    });
+    const auto block = std::make_unique<SampleBlock>();
+    for (size_t i=0; i<numBlocks; ++i) {
+        fillBlock(*block, i);
+        queue.push(*block);
+    }
+    queue.closeInlet();
+    consumer.join();
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    printf("(checksum %.6e) ", checksum);
+    return numBlocks/elapsedTime.count();
+}
+
+/**
+ * @brief Stream blocks which are filled and read in place with `claim`/`commit` and `borrow`/`release`.
+ *
+ * @return throughput in blocks per second
+ */
+static double measureZeroCopy(size_t numBlocks, size_t queueDepth) {
+    BlockQueue queue(queueDepth);
+    double checksum = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+    std::thread consumer([&queue, &checksum]{
+        while (SampleBlock *block = queue.borrow()) {
+            checksum += sumBlock(*block);
+            queue.release(block);
+        }
+    });
+    for (size_t i=0; i<numBlocks; ++i) {
+        SampleBlock *const block = queue.claim();
+        fillBlock(*block, i);
+        queue.commit(block);
+    }
+    queue.closeInlet();
+    consumer.join();
+    const std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+    printf("(checksum %.6e) ", checksum);
+    return numBlocks/elapsedTime.count();
+}
+
+int main() {
+    constexpr size_t numBlocks = 20000;
+    constexpr size_t queueDepth = 16;
+
+    printf("64 KiB blocks, %zu blocks, queue depth %zu\n", numBlocks, queueDepth);
+    const double throughput_copy = measureCopy(numBlocks, queueDepth);
+    printf("push/pop [block/s]: %.3e\n", throughput_copy);
+    const double throughput_zeroCopy = measureZeroCopy(numBlocks, queueDepth);
+    printf("claim/commit, borrow/release [block/s]: %.3e\n", throughput_zeroCopy);
+    printf("ratio: %.2f\n", throughput_zeroCopy/throughput_copy);
+
+    return EXIT_SUCCESS;
+}
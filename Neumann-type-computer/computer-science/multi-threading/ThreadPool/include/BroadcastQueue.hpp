@@ -0,0 +1,280 @@
+/**
+ * @file BroadcastQueue.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief single-producer multi-consumer broadcast ring
+ * @version 0.1.3
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __BROADCAST_QUEUE__
+#define __BROADCAST_QUEUE__
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "ConcurrencyUtil.hpp"
+#include "EventCount.hpp"
+
+/**
+ * @brief bounded single-producer multi-consumer queue in which every consumer sees every element
+ * @details Each consumer has its own cursor and reads the elements in place with `borrow`/`release`, so an element is never copied per consumer.
+ * The slowest consumer gates the producer: a slot is reused only after all the consumers released it.
+ * `push` and `emplace` must be called only from one thread. `closeInlet` may be called from any thread: a push racing it is either rejected or seen by every consumer (as `SpscMultiThreadQueue`).
+ * Each consumer index must be used only from one thread at a time.
+ * Threads block (in `EventCount`) only when the queue is full (for the slowest consumer) or empty (for the calling consumer).
+ *
+ * @tparam T_elem the data type of elements
+ */
+template <typename T_elem>
+class BroadcastQueue {
+    static_assert(std::is_nothrow_move_constructible_v<T_elem>, "A slot is refilled by moving the new element in after destroying the old one, which must not throw.");
+
+    private:
+
+        struct Slot {
+            alignas(T_elem) unsigned char storage[sizeof(T_elem)];
+
+            T_elem *elemPtr() {return std::launder(reinterpret_cast<T_elem *>(storage));}
+        };
+
+        struct alignas(CACHE_LINE_SIZE) Cursor {
+            std::atomic<size_t> pos{0}; // the position of the next element to be read
+            size_t cachedTail = 0; // consumer-local copy of `m_tail`
+        };
+
+        const size_t m_capacity;
+        const size_t m_numSlots;
+        const size_t m_numConsumers;
+        const std::unique_ptr<Slot[]> m_slots;
+        const std::unique_ptr<Cursor[]> m_cursors;
+
+        /* producer side */
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};
+        size_t m_cachedMinPos = 0; // producer-local copy of the position of the slowest consumer
+
+        alignas(CACHE_LINE_SIZE) std::atomic<bool> m_isInletClosed{false};
+        std::atomic<bool> m_isPushing{false}; // The producer is in `emplace` and may still put an element into the queue.
+        EventCount m_ec_notFull;
+        EventCount m_ec_notEmpty;
+
+        /**
+         * @brief Get the position of the slowest consumer.
+         */
+        size_t minPos() const {
+            size_t pos = m_cursors[0].pos.load(std::memory_order_acquire);
+            for (size_t i=1; i<m_numConsumers; ++i) {
+                pos = std::min(pos, m_cursors[i].pos.load(std::memory_order_acquire));
+            }
+            return pos;
+        }
+
+        /**
+         * @brief Check if the consumer `i` has an element to read, refreshing its cached tail if needed. Called only by the consumer.
+         */
+        bool hasElement(size_t i) {
+            Cursor &cursor = m_cursors[i];
+            const size_t pos = cursor.pos.load(std::memory_order_relaxed);
+            if (pos == cursor.cachedTail) {
+                cursor.cachedTail = m_tail.load(std::memory_order_acquire);
+            }
+            return pos != cursor.cachedTail;
+        }
+
+        /**
+         * @brief Put an element into the queue, blocking while the queue is full. Called only by the producer, marked as in `emplace`.
+         */
+        template <typename... T_args>
+        bool emplaceInFlight(T_args&&... args) {
+            if (m_isInletClosed.load(std::memory_order_seq_cst)) {
+                return false;
+            }
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedMinPos >= m_capacity) {
+                m_cachedMinPos = minPos();
+                if (tail - m_cachedMinPos >= m_capacity) {
+                    m_ec_notFull.wait([&]{
+                        if (m_isInletClosed.load(std::memory_order_seq_cst)) {
+                            return true;
+                        }
+                        m_cachedMinPos = minPos();
+                        return tail - m_cachedMinPos < m_capacity;
+                    });
+                    if (m_isInletClosed.load(std::memory_order_relaxed)) {
+                        return false;
+                    }
+                }
+            }
+            Slot &slot = m_slots[tail & (m_numSlots-1)];
+            if (tail >= m_numSlots) {
+                /* Every consumer has released the element pushed `m_numSlots` elements ago. Build the new element first, so that a throwing constructor leaves the old one alive for the destructor. */
+                T_elem elem(std::forward<T_args>(args)...);
+                slot.elemPtr()->~T_elem();
+                new (slot.storage) T_elem(std::move(elem));
+            } else {
+                new (slot.storage) T_elem(std::forward<T_args>(args)...);
+            }
+            m_tail.store(tail+1, std::memory_order_release);
+            m_ec_notEmpty.notifyAll();
+            return true;
+        }
+
+        /**
+         * @brief Mark the producer as out of `emplace`. The consumers waiting on the closed queue have to re-check once it leaves.
+         */
+        void leaveEmplace() {
+            m_isPushing.store(false, std::memory_order_seq_cst);
+            if (m_isInletClosed.load(std::memory_order_seq_cst)) {
+                m_ec_notEmpty.notifyAll();
+            }
+        }
+
+    public:
+        /**
+         * @brief Construct a new BroadcastQueue object
+         *
+         * @param[in] capacity The max number of the elements which the slowest consumer can lag behind the producer, must be 1 or greater. The ring itself is rounded up to a power of two.
+         * @param[in] numConsumers the number of the consumers, must be 1 or greater. Consumers are identified by indices in [0, numConsumers).
+         */
+        BroadcastQueue(size_t capacity, size_t numConsumers) : m_capacity(capacity), m_numSlots(ceilPow2(capacity)), m_numConsumers(numConsumers), m_slots(new Slot[ceilPow2(capacity)]), m_cursors(new Cursor[numConsumers]) {
+            assert(capacity > 0);
+            assert(numConsumers > 0);
+        }
+
+        BroadcastQueue(const BroadcastQueue &) = delete;
+        BroadcastQueue &operator=(const BroadcastQueue &) = delete;
+
+        /**
+         * @brief Destroy the BroadcastQueue object and the remaining elements
+         */
+        ~BroadcastQueue() {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            for (size_t pos = (tail > m_numSlots) ? tail-m_numSlots : 0; pos != tail; ++pos) {
+                m_slots[pos & (m_numSlots-1)].elemPtr()->~T_elem();
+            }
+        }
+
+        /**
+         * @brief Get the capacity of the queue
+         *
+         * @return capacity
+         */
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        /**
+         * @brief Get the number of the consumers
+         *
+         * @return the number of the consumers
+         */
+        size_t numConsumers() const {
+            return m_numConsumers;
+        }
+
+        /**
+         * @brief Check if the inlet is closed
+         *
+         * @retval true the inlet is closed
+         * @retval false the inlet is open
+         */
+        bool isInletClosed() const {
+            return m_isInletClosed.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Push an element to the queue. If the slowest consumer lags `capacity` elements behind, the caller thread is blocked until it catches up or the queue is closed.
+         * @details Only one thread may call this method.
+         *
+         * @param[in] elem the data to be pushed into the queue
+         * @retval true The data was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        bool push(T_elem elem) {
+            return emplace(std::move(elem));
+        }
+
+        /**
+         * @brief Construct an element in place at the end of the queue. Blocks as `push` does.
+         *
+         * @tparam T_args the types of the constructor arguments
+         * @param[in] args the arguments forwarded to the constructor of `T_elem`
+         * @return the same as `push`
+         */
+        template <typename... T_args>
+        bool emplace(T_args&&... args) {
+            /* The seq_cst store and load pair with the ones of `closeInlet` and `borrow`: either this push sees the closure, or the consumers see this push in flight. */
+            m_isPushing.store(true, std::memory_order_seq_cst);
+            bool isPushed;
+            try {
+                isPushed = emplaceInFlight(std::forward<T_args>(args)...);
+            } catch (...) {
+                leaveEmplace();
+                throw;
+            }
+            leaveEmplace();
+            return isPushed;
+        }
+
+        /**
+         * @brief Get the next element for the consumer `consumer`, to be read in place. If there is none, the caller thread is blocked until one is pushed or the queue is closed.
+         * @details The element stays valid until `release` is called with the same consumer index.
+         *
+         * @param[in] consumer the consumer index
+         * @return pointer to the element, or `nullptr` if the queue was closed and this consumer has read all the elements
+         */
+        const T_elem *borrow(size_t consumer) {
+            assert(consumer < m_numConsumers);
+            if (!hasElement(consumer)) {
+                bool isAvailable = false;
+                m_ec_notEmpty.wait([&]{
+                    isAvailable = hasElement(consumer);
+                    if (isAvailable) {
+                        return true;
+                    }
+                    /* Once the queue is closed and the producer is out of `emplace`, its last element is visible. */
+                    if (m_isInletClosed.load(std::memory_order_seq_cst) && !m_isPushing.load(std::memory_order_seq_cst)) {
+                        isAvailable = hasElement(consumer);
+                        return true;
+                    }
+                    return false;
+                });
+                if (!isAvailable) {
+                    return nullptr;
+                }
+            }
+            return m_slots[m_cursors[consumer].pos.load(std::memory_order_relaxed) & (m_numSlots-1)].elemPtr();
+        }
+
+        /**
+         * @brief Finish reading the element returned by `borrow`, and move the cursor of the consumer to the next element.
+         *
+         * @param[in] consumer the consumer index
+         */
+        void release(size_t consumer) {
+            assert(consumer < m_numConsumers);
+            Cursor &cursor = m_cursors[consumer];
+            cursor.pos.store(cursor.pos.load(std::memory_order_relaxed)+1, std::memory_order_release);
+            m_ec_notFull.notifyOne();
+        }
+
+        /**
+         * @brief Close the queue inlet.
+         * @details After the queue inlet is closed:
+         * @par 1. Following or currently-blocked `push` callings return with `false`.
+         * @par 2. Each consumer can still `borrow` the elements it has not read, then `borrow` returns `nullptr`.
+         */
+        void closeInlet() {
+            m_isInletClosed.store(true, std::memory_order_seq_cst);
+            m_ec_notFull.notifyAll();
+            m_ec_notEmpty.notifyAll();
+        }
+};
+
+#endif // __BROADCAST_QUEUE__
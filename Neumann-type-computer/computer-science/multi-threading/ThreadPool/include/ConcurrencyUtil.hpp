@@ -0,0 +1,45 @@
+/**
+ * @file ConcurrencyUtil.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief small utilities shared by the queues and the thread pools
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __CONCURRENCY_UTIL__
+#define __CONCURRENCY_UTIL__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+/**
+ * @brief the assumed size of a cache line, by which data written by different threads are separated to avoid false sharing
+ */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Get the smallest power of two which is equal to or greater than `n`.
+ */
+inline size_t ceilPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {p <<= 1;}
+    return p;
+}
+
+/**
+ * @brief Get a random number from a per-thread xorshift generator, e.g. to choose a shard or a victim of stealing.
+ */
+inline uint64_t xorshiftRandom() {
+    thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+#endif // __CONCURRENCY_UTIL__
@@ -0,0 +1,79 @@
+/**
+ * @file EventCount.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief blocking helper for lock-free queues
+ * @version 0.1.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __EVENT_COUNT__
+#define __EVENT_COUNT__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * @brief Lets a thread sleep until a lock-free condition becomes true, without making the notifier pay for a mutex when nobody sleeps.
+ * @details The waiter registers itself before evaluating its predicate and the notifier publishes its state change before looking at the number of waiters.
+ * Both sides are separated by sequentially-consistent fences, so either the waiter sees the new state or the notifier sees the waiter; no wakeup is lost.
+ */
+class EventCount {
+    private:
+        std::mutex m_mtx;
+        std::condition_variable m_cv;
+        std::atomic<unsigned int> m_numWaiters{0};
+
+    public:
+        /**
+         * @brief Block the caller thread until `pred` returns `true`.
+         * @details `pred` is evaluated under the internal mutex, and may be evaluated several times.
+         *
+         * @tparam T_pred callable type which takes no argument and returns `bool`
+         * @param[in] pred the condition to wait for
+         */
+        template <typename T_pred>
+        void wait(T_pred pred) {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_numWaiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_cv.wait(lock, pred);
+            m_numWaiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Check if any thread is waiting.
+         * @details A notifier whose state change was a sequentially-consistent read-modify-write may call this first to skip `notifyOne` and its fence while nobody waits:
+         * the read-modify-write and this load are ordered as the fence of `notifyOne` would order them.
+         */
+        bool hasWaiters() const {return m_numWaiters.load(std::memory_order_seq_cst) != 0;}
+
+        /**
+         * @brief Wake up one waiting thread if any. Call this after the state change the waiters are interested in.
+         */
+        void notifyOne() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_numWaiters.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+            {std::lock_guard<std::mutex> lock(m_mtx);}
+            m_cv.notify_one();
+        }
+
+        /**
+         * @brief Wake up all the waiting threads. Call this after the state change the waiters are interested in.
+         */
+        void notifyAll() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_numWaiters.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+            {std::lock_guard<std::mutex> lock(m_mtx);}
+            m_cv.notify_all();
+        }
+};
+
+#endif // __EVENT_COUNT__
@@ -0,0 +1,160 @@
+/**
+ * @file InlineTask.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief move-only type-erased callable with inline storage for small callables
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __INLINE_TASK__
+#define __INLINE_TASK__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief move-only type-erased callable taking `T_params...` and returning nothing
+ * @details Unlike `std::function`, the callable needs not be copyable, e.g. a lambda capturing a `TaskPromise`.
+ * A callable of up to `INLINE_SIZE` bytes whose move constructor does not throw is stored inside the object, so storing it allocates nothing;
+ * larger callables are allocated on the heap.
+ *
+ * @tparam T_params the parameter types of the callable
+ */
+template <typename... T_params>
+class InlineTask {
+    public:
+        static constexpr size_t INLINE_SIZE = 48;
+
+    private:
+        struct Ops {
+            void (*run)(void *storage, T_params... params);
+            void (*moveTo)(void *src, void *dst); // move the stored callable from `src` to `dst`, leaving nothing in `src`
+            void (*destroy)(void *storage);
+        };
+
+        template <typename T_func>
+        static constexpr bool isInline = (sizeof(T_func) <= INLINE_SIZE) && (alignof(T_func) <= alignof(std::max_align_t)) && std::is_nothrow_move_constructible_v<T_func>;
+
+        /**
+         * @brief the operations on a stored callable of type `T_func`
+         */
+        template <typename T_func>
+        struct Model {
+            static T_func *get(void *storage) {
+                if constexpr (isInline<T_func>) {
+                    return std::launder(reinterpret_cast<T_func *>(storage));
+                } else {
+                    return *reinterpret_cast<T_func **>(storage);
+                }
+            }
+
+            static void run(void *storage, T_params... params) {(*get(storage))(std::forward<T_params>(params)...);}
+
+            static void moveTo(void *src, void *dst) {
+                if constexpr (isInline<T_func>) {
+                    new (dst) T_func(std::move(*get(src)));
+                    get(src)->~T_func();
+                } else {
+                    *reinterpret_cast<T_func **>(dst) = get(src);
+                }
+            }
+
+            static void destroy(void *storage) {
+                if constexpr (isInline<T_func>) {
+                    get(storage)->~T_func();
+                } else {
+                    delete get(storage);
+                }
+            }
+
+            static constexpr Ops ops{&run, &moveTo, &destroy};
+        };
+
+        alignas(std::max_align_t) unsigned char m_storage[INLINE_SIZE];
+        const Ops *m_ops = nullptr;
+
+    public:
+        /**
+         * @brief Construct an empty InlineTask object
+         */
+        InlineTask() = default;
+
+        /**
+         * @brief Construct a new InlineTask object which holds a callable
+         *
+         * @tparam T_func callable type which takes `T_params...`
+         * @param[in] func the callable, moved or copied into the object
+         */
+        template <typename T_func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T_func>, InlineTask> && std::is_invocable_v<std::decay_t<T_func> &, T_params...>>>
+        explicit InlineTask(T_func &&func) {
+            using Func = std::decay_t<T_func>;
+            if constexpr (isInline<Func>) {
+                new (m_storage) Func(std::forward<T_func>(func));
+            } else {
+                *reinterpret_cast<Func **>(m_storage) = new Func(std::forward<T_func>(func));
+            }
+            m_ops = &Model<Func>::ops;
+        }
+
+        InlineTask(InlineTask &&other) noexcept : m_ops(other.m_ops) {
+            if (m_ops != nullptr) {
+                m_ops->moveTo(other.m_storage, m_storage);
+                other.m_ops = nullptr;
+            }
+        }
+
+        InlineTask &operator=(InlineTask &&other) noexcept {
+            if (this != &other) {
+                reset();
+                if (other.m_ops != nullptr) {
+                    other.m_ops->moveTo(other.m_storage, m_storage);
+                    m_ops = other.m_ops;
+                    other.m_ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        InlineTask(const InlineTask &) = delete;
+        InlineTask &operator=(const InlineTask &) = delete;
+
+        ~InlineTask() {reset();}
+
+        /**
+         * @brief Check if the object holds a callable
+         */
+        explicit operator bool() const {return m_ops != nullptr;}
+
+        /**
+         * @brief Destroy the held callable, if any.
+         */
+        void reset() {
+            if (m_ops != nullptr) {
+                m_ops->destroy(m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+        /**
+         * @brief Call the held callable in current thread. The object must hold a callable.
+         */
+        void operator()(T_params... params) {m_ops->run(m_storage, std::forward<T_params>(params)...);}
+
+        /**
+         * @brief Get the held callable if it is of type `T_func`.
+         *
+         * @return pointer to the held callable, or `nullptr` if the object is empty or holds a callable of another type
+         */
+        template <typename T_func>
+        T_func *target() {return (m_ops == &Model<T_func>::ops) ? Model<T_func>::get(m_storage) : nullptr;}
+
+        template <typename T_func>
+        const T_func *target() const {return const_cast<InlineTask *>(this)->template target<T_func>();}
+};
+
+#endif // __INLINE_TASK__
@@ -0,0 +1,300 @@
+/**
+ * @file LockFreeMultiThreadQueue.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief lock-free bounded MPMC queue based on [Dmitry Vyukov's bounded MPMC queue](https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue)
+ * @version 0.4.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __LOCK_FREE_MULTI_THREAD_QUEUE__
+#define __LOCK_FREE_MULTI_THREAD_QUEUE__
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "ConcurrencyUtil.hpp"
+#include "EventCount.hpp"
+#include "QueueInlet.hpp"
+
+/**
+ * @brief lock-free bounded multi-producer multi-consumer queue
+ * @details Drop-in replacement of `MultiThreadQueue`.
+ * Each slot carries a sequence number which tells producers and consumers whose turn it is, so `push` and `pop` only contend on a single CAS when the queue is neither full nor empty.
+ * Threads block (in `EventCount`) only when the queue is full or empty.
+ *
+ * @tparam T_elem the data type of elements, which must be nothrow move constructible and assignable
+ */
+template <typename T_elem>
+class LockFreeMultiThreadQueue {
+    static_assert(std::is_nothrow_move_constructible_v<T_elem> && std::is_nothrow_move_assignable_v<T_elem>, "A slot is claimed before the element is moved in or out, so a throwing move would leave the slot unpublished and wedge the ring.");
+
+    private:
+
+        struct alignas(CACHE_LINE_SIZE) Slot {
+            std::atomic<size_t> seq;
+            alignas(T_elem) unsigned char storage[sizeof(T_elem)];
+
+            T_elem *elemPtr() {return std::launder(reinterpret_cast<T_elem *>(storage));}
+        };
+
+        const size_t m_capacity;
+        const size_t m_numSlots; // the ring size, `m_capacity` but at least 2: in a 1-slot ring a filled slot's sequence number equals the next enqueue position, so the slot would be overwritten
+        const std::unique_ptr<Slot[]> m_slots;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_enqueuePos{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_dequeuePos{0};
+        alignas(CACHE_LINE_SIZE) QueueInlet m_inlet;
+        EventCount m_ec_notFull;
+        EventCount m_ec_notEmpty;
+
+        /**
+         * @brief Try to put an element into the queue without blocking.
+         *
+         * @param[in,out] elem the data to be moved into the queue, which is left untouched on failure
+         * @retval true The data was pushed.
+         * @retval false The queue was full.
+         */
+        bool tryEnqueue(T_elem &elem) {
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            Slot *slot;
+            for (;;) {
+                if ((m_capacity < m_numSlots) && (static_cast<intptr_t>(pos - m_dequeuePos.load(std::memory_order_acquire)) >= static_cast<intptr_t>(m_capacity))) {
+                    return false; // full, though the ring has a spare slot; a stale dequeue position only errs toward full, and a stale `pos` is reloaded below
+                }
+                slot = &m_slots[pos % m_numSlots];
+                const size_t seq = slot->seq.load(std::memory_order_acquire);
+                const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            new (slot->storage) T_elem(std::move(elem));
+            slot->seq.store(pos+1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Try to take an element from the queue without blocking.
+         *
+         * @param[out] elem pointer to the data which the popped data to be stored, or `nullptr` to discard the popped data
+         * @retval true The data was popped.
+         * @retval false The queue was empty.
+         */
+        bool tryDequeue(T_elem *elem) {
+            size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            Slot *slot;
+            for (;;) {
+                slot = &m_slots[pos % m_numSlots];
+                const size_t seq = slot->seq.load(std::memory_order_acquire);
+                const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos+1);
+                if (diff == 0) {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+            T_elem *const ptr = slot->elemPtr();
+            if (elem != nullptr) {
+                *elem = std::move(*ptr);
+            }
+            ptr->~T_elem();
+            slot->seq.store(pos+m_numSlots, std::memory_order_release);
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Construct a new LockFreeMultiThreadQueue object
+         *
+         * @param[in] capacity The max number of the elements which can be held in the queue, must be 1 or greater. The ring has at least 2 slots.
+         */
+        LockFreeMultiThreadQueue(size_t capacity) : m_capacity(capacity), m_numSlots(std::max<size_t>(capacity, 2)), m_slots(new Slot[m_numSlots]) {
+            assert(capacity > 0);
+            for (size_t i=0; i<m_numSlots; ++i) {
+                m_slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        LockFreeMultiThreadQueue(const LockFreeMultiThreadQueue &) = delete;
+        LockFreeMultiThreadQueue &operator=(const LockFreeMultiThreadQueue &) = delete;
+
+        /**
+         * @brief Destroy the LockFreeMultiThreadQueue object and the remaining elements
+         */
+        ~LockFreeMultiThreadQueue() {
+            popAll();
+        }
+
+        /**
+         * @brief Get the capacity of the queue
+         *
+         * @return capacity
+         */
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        /**
+         * @brief Check if the inlet is closed
+         *
+         * @retval true the inlet is closed
+         * @retval false the inlet is open
+         */
+        bool isInletClosed() const {
+            return m_inlet.isClosed();
+        }
+
+        /**
+         * @brief Get the generation of the queue, which is incremented by every `reopenInlet`
+         *
+         * @return the generation, 0 until the queue is reopened for the first time
+         */
+        size_t generation() const {
+            return m_inlet.generation();
+        }
+
+        /**
+         * @brief Push an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         *
+         * @param[in] elem the data to be pushed into the queue
+         * @retval true The data was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        bool push(T_elem elem) {
+            return m_inlet.push(m_ec_notFull, m_ec_notEmpty, [&]{return tryEnqueue(elem);}, [this]{m_ec_notEmpty.notifyOne();});
+        }
+
+        /**
+         * @brief Push an element to the queue without blocking.
+         *
+         * @param[in,out] elem the data to be moved into the queue, which is left untouched on failure
+         * @retval true The data was pushed into the queue.
+         * @retval false The queue was closed or full.
+         */
+        bool tryPush(T_elem &elem) {
+            return m_inlet.tryPush(m_ec_notEmpty, [&]{return tryEnqueue(elem);}, [this]{m_ec_notEmpty.notifyOne();});
+        }
+
+        /**
+         * @brief Pop an element from the queue. If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed.
+         *
+         * @param[out] elem the reference to the data which the popped data to be stored
+         * @retval true The data was successfully popped from the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-empty.
+         */
+        bool pop(T_elem &elem) {
+            bool isPopped = tryDequeue(&elem);
+            if (!isPopped) {
+                m_ec_notEmpty.wait([&]{
+                    isPopped = tryDequeue(&elem);
+                    if (isPopped) {
+                        return true;
+                    }
+                    if (m_inlet.isDrained()) {
+                        isPopped = tryDequeue(&elem);
+                        return true;
+                    }
+                    return false;
+                });
+            }
+            if (isPopped) {
+                m_ec_notFull.notifyOne();
+            }
+            return isPopped;
+        }
+
+        /**
+         * @brief Pop an element from the queue without blocking.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @retval true The data was popped from the queue.
+         * @retval false The queue was empty.
+         */
+        bool tryPop(T_elem &elem) {
+            if (!tryDequeue(&elem)) {
+                return false;
+            }
+            m_ec_notFull.notifyOne();
+            return true;
+        }
+
+        /**
+         * @brief Take all the elements out of the queue and return them to the caller, in FIFO order.
+         * @details The elements are dequeued one by one, but no lock is held, so pushers are not stalled. `T_elem` must be default-constructible.
+         *
+         * @return the elements which were in the queue
+         */
+        std::deque<T_elem> drain() {
+            std::deque<T_elem> drained;
+            T_elem elem;
+            while (tryDequeue(&elem)) {
+                drained.push_back(std::move(elem));
+            }
+            if (!drained.empty()) {
+                m_ec_notFull.notifyAll();
+            }
+            return drained;
+        }
+
+        /**
+         * @brief Pop all elements from the queue.
+         * @details One typically uses this method to abort pending tasks under producer-consumer thread model; calls `closeInlet` method, then calls `popAll` method.
+         */
+        void popAll() {
+            size_t numPopped = 0;
+            while (tryDequeue(nullptr)) {
+                ++numPopped;
+            }
+            if (numPopped > 0) {
+                m_ec_notFull.notifyAll();
+            }
+        }
+
+        /**
+         * @brief Close the queue inlet.
+         * @details After the queue inlet is closed:
+         * @par 1. Following or currently-blocked `push` callings return with `false`.
+         * @par 2. Following or currently-blocked `pop` callings return with `true` as far as there is at least one element in the queue, otherwise return with `false`.
+         */
+        void closeInlet() {
+            m_inlet.close();
+            m_ec_notFull.notifyAll();
+            m_ec_notEmpty.notifyAll();
+        }
+
+        /**
+         * @brief Reopen the closed queue inlet and start a new generation, so that the queue can be used again.
+         * @details The elements left in the queue are kept. See `QueueInlet::reopen` for the consumers still blocked in `pop`.
+         */
+        void reopenInlet() {
+            m_inlet.reopen();
+        }
+};
+
+/**
+ * @brief queue policy to build containers (e.g. `BasicThreadPool`) on `LockFreeMultiThreadQueue`
+ */
+struct LockFreeQueuePolicy {
+    template <typename T_elem>
+    using Queue = LockFreeMultiThreadQueue<T_elem>;
+};
+
+#endif // __LOCK_FREE_MULTI_THREAD_QUEUE__
@@ -2,8 +2,8 @@
  * @file MultiThreadQueue.hpp
  * @author motchy (motchy869@gmail.com)
  * @brief thread-safe queue inspired by [条件変数 Step-by-Step入門](https://yohhoy.hatenablog.jp/entry/2014/09/23/193617)
- * @version 0.0.1
- * @date 2021-07-28
+ * @version 0.15.0
+ * @date 2026-10-17
  * @copyright Copyright (c) 2021 motchy
  * https://motchy869.com/wordpress/
  * Released under the MIT license
@@ -12,34 +12,540 @@
 #ifndef __MULTI_THREAD_QUEUE__
 #define __MULTI_THREAD_QUEUE__
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+#include <deque>
+#include <limits>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "QueueStats.hpp"
+#include "QueueStorage.hpp"
+#include "WaitStrategy.hpp"
+
+/**
+ * @brief result of the non-blocking and deadline-aware queue operations
+ */
+enum class QueueOpStatus {
+    SUCCESS, // The element was pushed or popped.
+    CLOSED, // The queue inlet was closed (for pop: closed and empty).
+    TIMEOUT, // The deadline passed before the queue became not-full (for push) or not-empty (for pop). Non-blocking `try*` methods return this instead of blocking.
+    DROPPED // The queue was full and the element was dropped (`OverflowPolicy::DROP_NEWEST`, or `DROP_OLDEST` while the oldest slot is borrowed).
+};
+
+/**
+ * @brief what `push` does when the queue is full
+ */
+enum class OverflowPolicy {
+    BLOCK, // Block the caller until the queue is not-full or is closed.
+    DROP_OLDEST, // Drop the oldest element to make room, like an overwriting ring buffer (cf. RingStack); if that frees no slot because the oldest slot is borrowed, drop the incoming element instead. `push` never blocks.
+    DROP_NEWEST // Reject the incoming element. `push` never blocks.
+};
+
+/**
+ * @brief thresholds which decide how many blocked `pop` callings are woken up for the backlog
+ * @details A popper woken up and not yet running counts as awake, so a burst of pushes does not signal it again.
+ * With the defaults, every element of the backlog wakes one blocked popper.
+ * A larger `lowWatermark` lets each popper drain a batch (e.g. with `popBulk`), which saves context switches and futex calls per element.
+ * At least one popper is always woken for a non-empty queue, so no element is left behind.
+ */
+struct NotifyWatermarks {
+    size_t lowWatermark = 1; // One blocked popper is woken up for every `lowWatermark` elements of the backlog. Must be 1 or greater.
+    size_t highWatermark = std::numeric_limits<size_t>::max(); // All the blocked poppers are woken up at once when the backlog reaches `highWatermark`.
+};
+
+/**
+ * @brief interface to be told when a queue becomes ready to pop (not-empty, or closed)
+ * @details Used by `QueueSelector` to wait on several queues with one thread.
+ */
+class QueueReadinessObserver {
+    public:
+        virtual ~QueueReadinessObserver() = default;
+
+        /**
+         * @brief Called when an observed queue becomes not-empty or closed.
+         * @details Called with the lock of the queue held, so it must return quickly and must not call the queue.
+         */
+        virtual void onReady() = 0;
+};
+
+#if defined(__cpp_impl_coroutine)
+/**
+ * @brief interface to resume the coroutines suspended in `MultiThreadQueue::asyncPush` and `MultiThreadQueue::asyncPop`
+ * @details Lets the user choose the threads on which the coroutines go on, e.g. an I/O loop or a few worker threads.
+ */
+class CoroutineExecutor {
+    public:
+        virtual ~CoroutineExecutor() = default;
+
+        /**
+         * @brief Arrange for `handle.resume()` to be called.
+         * @details Called with the lock of the queue held, so it must only enqueue the handle without blocking, and must not resume it inline.
+         */
+        virtual void schedule(std::coroutine_handle<> handle) = 0;
+};
+#endif
 
 /**
  * @brief thread-safe queue
+ * @details With `RingStoragePolicy`, large elements can be handed over without copying them: a producer `claim`s a slot, fills it in place and `commit`s it, and a consumer `borrow`s the front slot, reads it in place and `release`s it.
+ * The slots are recycled, so no memory is allocated after construction.
+ * With C++20, coroutines can push and pop through `asyncPush`/`asyncPop` without blocking a thread.
  *
  * @tparam T_elem the data type of elements
+ * @tparam T_storagePolicy storage policy which selects the container holding the elements, `DequeStoragePolicy` (default) or `RingStoragePolicy`
+ * @tparam T_stats statistics collector, `NullQueueStats` (default, compiled out) or `QueueStats`
  */
-template <typename T_elem>
+template <typename T_elem, typename T_storagePolicy = DequeStoragePolicy, typename T_stats = NullQueueStats>
 class MultiThreadQueue {
     private:
+        using Storage = typename T_storagePolicy::template Storage<T_elem>;
+
         const size_t m_capacity;
-        std::queue<T_elem> m_queue;
+        const WaitStrategy m_waitStrategy;
+        const OverflowPolicy m_overflowPolicy;
+        const NotifyWatermarks m_watermarks;
+        Storage m_queue;
         std::mutex m_mtx;
-        bool m_isInletClosed = false;
+        std::atomic<bool> m_isInletClosed{false}; // written under `m_mtx`, read without it while spinning
+        std::atomic<size_t> m_size{0}; // mirror of `m_queue.size()` for spinning threads, written under `m_mtx`
+        std::atomic<size_t> m_generation{0}; // the number of the reopenings, written under `m_mtx`
         std::condition_variable m_cv_notFull;
         std::condition_variable m_cv_notEmpty;
+        size_t m_numWaitingPushers = 0; // the number of threads blocked on `m_cv_notFull`, guarded by `m_mtx`
+        size_t m_numWaitingPoppers = 0; // the number of threads blocked on `m_cv_notEmpty`, guarded by `m_mtx`
+        size_t m_numPendingPopperWakeups = 0; // the number of the threads blocked on `m_cv_notEmpty` which have been notified but not woken up yet, guarded by `m_mtx`
+        size_t m_numDroppedElements = 0; // guarded by `m_mtx`
+        size_t m_numClaimedSlots = 0; // the number of the slots claimed but not committed yet, guarded by `m_mtx`
+        AdaptiveSpinner m_pushSpinner;
+        AdaptiveSpinner m_popSpinner;
+        T_stats m_stats;
+        std::vector<QueueReadinessObserver *> m_observers; // guarded by `m_mtx`
+
+#if defined(__cpp_impl_coroutine)
+        /**
+         * @brief node of the intrusive list of the coroutines suspended in `asyncPop`, which lives in the coroutine frame
+         */
+        struct AsyncPopWaiter {
+            AsyncPopWaiter *next = nullptr;
+            CoroutineExecutor &executor;
+            std::coroutine_handle<> handle;
+            std::optional<T_elem> elem; // the element handed over, or empty if the queue was drained
+        };
+
+        /**
+         * @brief node of the intrusive list of the coroutines suspended in `asyncPush`, which lives in the coroutine frame
+         */
+        struct AsyncPushWaiter {
+            AsyncPushWaiter *next = nullptr;
+            CoroutineExecutor &executor;
+            std::coroutine_handle<> handle;
+            T_elem *elem; // the element to be pushed
+            bool isPushed = false;
+        };
+
+        /**
+         * @brief FIFO intrusive list of waiters
+         */
+        template <typename T_waiter>
+        struct WaiterList {
+            T_waiter *head = nullptr;
+            T_waiter *tail = nullptr;
+
+            bool empty() const {return head == nullptr;}
+
+            void pushBack(T_waiter *waiter) {
+                waiter->next = nullptr;
+                if (tail == nullptr) {
+                    head = waiter;
+                } else {
+                    tail->next = waiter;
+                }
+                tail = waiter;
+            }
+
+            T_waiter *popFront() {
+                T_waiter *const waiter = head;
+                head = waiter->next;
+                if (head == nullptr) {
+                    tail = nullptr;
+                }
+                return waiter;
+            }
+        };
+
+        WaiterList<AsyncPopWaiter> m_asyncPoppers; // guarded by `m_mtx`
+        WaiterList<AsyncPushWaiter> m_asyncPushers; // guarded by `m_mtx`
+
+        /**
+         * @brief Take the front element for a coroutine in `asyncPop`, or suspend it until an element arrives.
+         *
+         * @retval true The coroutine is suspended.
+         * @retval false The element was taken, or the queue is drained; the coroutine goes on.
+         */
+        bool suspendAsyncPopper(AsyncPopWaiter &waiter, std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (!m_queue.empty()) {
+                waiter.elem.emplace(std::move(m_queue.front()));
+                m_queue.pop();
+                serveAsyncWaitersLocked();
+                publishSize();
+                if (m_numWaitingPushers > 0) {
+                    notifyOne(m_cv_notFull);
+                }
+                return false;
+            }
+            if (isDrainedLocked()) {
+                return false;
+            }
+            waiter.handle = handle;
+            m_asyncPoppers.pushBack(&waiter);
+            return true;
+        }
+
+        /**
+         * @brief Push the element of a coroutine in `asyncPush`, or suspend it until there is room.
+         *
+         * @retval true The coroutine is suspended.
+         * @retval false The element was pushed or dropped, or the queue is closed; the coroutine goes on.
+         */
+        bool suspendAsyncPusher(AsyncPushWaiter &waiter, std::coroutine_handle<> handle) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (m_isInletClosed) {
+                return false;
+            }
+            if (isNotFullOrClosed()) {
+                if (makeRoomLocked()) {
+                    emplaceLocked(std::move(*waiter.elem));
+                    waiter.isPushed = true;
+                }
+                return false;
+            }
+            waiter.handle = handle;
+            m_asyncPushers.pushBack(&waiter);
+            return true;
+        }
+#endif
+
+        /**
+         * @brief Hand elements over to the suspended `asyncPop` coroutines, take elements in from the suspended `asyncPush` coroutines, and schedule their resumption.
+         * @details Must be called with `m_mtx` locked after every change of the size or of the closure. Does nothing unless coroutines are enabled (C++20).
+         */
+        void serveAsyncWaitersLocked() {
+#if defined(__cpp_impl_coroutine)
+            if (m_asyncPoppers.empty() && m_asyncPushers.empty()) {
+                return;
+            }
+            size_t numHandedOver = 0, numTakenIn = 0;
+            for (bool isProgressing = true; isProgressing;) {
+                isProgressing = false;
+                while (!m_asyncPoppers.empty() && !m_queue.empty()) {
+                    AsyncPopWaiter *const waiter = m_asyncPoppers.popFront();
+                    waiter->elem.emplace(std::move(m_queue.front()));
+                    m_queue.pop();
+                    waiter->executor.schedule(waiter->handle);
+                    ++numHandedOver;
+                    isProgressing = true;
+                }
+                while (!m_asyncPushers.empty() && !m_isInletClosed && (m_queue.occupied() < m_capacity)) {
+                    AsyncPushWaiter *const waiter = m_asyncPushers.popFront();
+                    m_queue.emplace(std::move(*waiter->elem));
+                    waiter->isPushed = true;
+                    waiter->executor.schedule(waiter->handle);
+                    ++numTakenIn;
+                    isProgressing = true;
+                }
+            }
+            if (m_isInletClosed) {
+                while (!m_asyncPushers.empty()) {
+                    AsyncPushWaiter *const waiter = m_asyncPushers.popFront();
+                    waiter->executor.schedule(waiter->handle);
+                }
+            }
+            if (isDrainedLocked() && m_queue.empty()) {
+                while (!m_asyncPoppers.empty()) {
+                    AsyncPopWaiter *const waiter = m_asyncPoppers.popFront();
+                    waiter->executor.schedule(waiter->handle);
+                }
+            }
+            if ((numHandedOver > 0) || (numTakenIn > 0)) {
+                publishSize();
+                if (numTakenIn > 0) {
+                    wakePoppersLocked();
+                }
+                notifyN(m_cv_notFull, numHandedOver, m_numWaitingPushers);
+            }
+#endif
+        }
+
+        /**
+         * @brief Wake up to `n` threads blocked on `cv`. Must be called with `m_mtx` locked.
+         *
+         * @param[in] cv the condition variable
+         * @param[in] n the number of the threads to be woken up
+         * @param[in] numWaiters the number of the threads currently blocked on `cv`
+         */
+        void notifyN(std::condition_variable &cv, size_t n, size_t numWaiters) {
+            if ((n == 0) || (numWaiters == 0)) {
+                return;
+            }
+            if (n >= numWaiters) {
+                notifyAll(cv);
+            } else {
+                for (size_t i=0; i<n; ++i) {notifyOne(cv);}
+            }
+        }
+
+        void notifyOne(std::condition_variable &cv) {
+            m_stats.recordNotifyOne();
+            cv.notify_one();
+        }
+
+        void notifyAll(std::condition_variable &cv) {
+            m_stats.recordNotifyAll();
+            cv.notify_all();
+        }
+
+        /**
+         * @brief Wake up blocked poppers for the current backlog according to `m_watermarks`. Must be called with `m_mtx` locked after elements become visible.
+         */
+        void wakePoppersLocked() {
+            if (m_numWaitingPoppers <= m_numPendingPopperWakeups) {
+                return;
+            }
+            const size_t backlog = m_queue.size();
+            if (backlog >= m_watermarks.highWatermark) {
+                notifyAllPoppers();
+                return;
+            }
+            const size_t numToBeAwake = std::min((backlog + m_watermarks.lowWatermark - 1)/m_watermarks.lowWatermark, m_numWaitingPoppers);
+            for (; m_numPendingPopperWakeups < numToBeAwake; ++m_numPendingPopperWakeups) {
+                notifyOne(m_cv_notEmpty);
+            }
+        }
+
+        void notifyAllPoppers() {
+            notifyAll(m_cv_notEmpty);
+            m_numPendingPopperWakeups = m_numWaitingPoppers;
+        }
+
+        /**
+         * @brief Account a popper woken up from `m_cv_notEmpty`. Must be called with `m_mtx` locked.
+         * @details A spurious wakeup is taken for a notified one, which only makes later pushes notify one more thread.
+         */
+        void onPopperWokenLocked() {
+            if (m_numPendingPopperWakeups > 0) {
+                --m_numPendingPopperWakeups;
+            }
+        }
+
+        bool isNotFullOrClosed() const {return (m_queue.occupied() < m_capacity) || (m_overflowPolicy != OverflowPolicy::BLOCK) || m_isInletClosed;}
+        bool isNotEmptyOrClosed() const {return !m_queue.empty() || isDrainedLocked();}
+
+        /**
+         * @brief Check if the queue is closed and no more element can become visible. Must be called with `m_mtx` locked.
+         */
+        bool isDrainedLocked() const {return m_isInletClosed && (m_numClaimedSlots == 0);}
+
+        /**
+         * @brief Publish the queue size to spinning threads. Must be called with `m_mtx` locked after every change of the size.
+         */
+        void publishSize() {
+            const size_t size = m_queue.size();
+            const size_t prevSize = m_size.load(std::memory_order_relaxed);
+            m_size.store(size, std::memory_order_relaxed);
+            m_stats.recordDepth(size);
+            if ((prevSize == 0) && (size > 0)) {
+                notifyObserversLocked();
+            }
+        }
+
+        /**
+         * @brief Tell the readiness observers that the queue became ready to pop. Must be called with `m_mtx` locked.
+         */
+        void notifyObserversLocked() {
+            for (QueueReadinessObserver *const observer : m_observers) {
+                observer->onReady();
+            }
+        }
+
+        /**
+         * @brief Under `WaitStrategy::SPIN_THEN_PARK`, spin without the lock until the queue looks not-full or closed.
+         * @details Must be called with `lock` locked, and returns with it locked. The caller still has to check the condition (and park if needed).
+         */
+        void spinForNotFull(std::unique_lock<std::mutex> &lock) {
+            if ((m_waitStrategy != WaitStrategy::SPIN_THEN_PARK) || isNotFullOrClosed()) {
+                return;
+            }
+            lock.unlock();
+            m_pushSpinner.spinUntil([this]{
+                return (m_size.load(std::memory_order_relaxed) < m_capacity) || m_isInletClosed.load(std::memory_order_relaxed);
+            });
+            lock.lock();
+        }
+
+        /**
+         * @brief Under `WaitStrategy::SPIN_THEN_PARK`, spin without the lock until the queue looks not-empty or closed.
+         * @details Must be called with `lock` locked, and returns with it locked. The caller still has to check the condition (and park if needed).
+         */
+        void spinForNotEmpty(std::unique_lock<std::mutex> &lock) {
+            if ((m_waitStrategy != WaitStrategy::SPIN_THEN_PARK) || isNotEmptyOrClosed()) {
+                return;
+            }
+            lock.unlock();
+            m_popSpinner.spinUntil([this]{
+                return (m_size.load(std::memory_order_relaxed) > 0) || m_isInletClosed.load(std::memory_order_relaxed);
+            });
+            lock.lock();
+        }
+
+        /**
+         * @brief Block the caller until the queue is not-full or closed. Must be called with `lock` locked, and returns with it locked.
+         */
+        void waitForNotFull(std::unique_lock<std::mutex> &lock) {
+            if (isNotFullOrClosed()) {
+                return;
+            }
+            const auto blockStart = m_stats.startBlock();
+            spinForNotFull(lock);
+            ++m_numWaitingPushers;
+            m_cv_notFull.wait(lock, [this]{return isNotFullOrClosed();});
+            --m_numWaitingPushers;
+            m_stats.recordProducerBlock(blockStart);
+        }
+
+        /**
+         * @brief Block the caller until the queue is not-full or closed, or `deadline` passes. Must be called with `lock` locked, and returns with it locked.
+         *
+         * @retval true The queue is not-full or closed.
+         * @retval false `deadline` passed.
+         */
+        template <typename T_clock, typename T_duration>
+        bool waitForNotFullUntil(std::unique_lock<std::mutex> &lock, const std::chrono::time_point<T_clock, T_duration> &deadline) {
+            if (isNotFullOrClosed()) {
+                return true;
+            }
+            const auto blockStart = m_stats.startBlock();
+            spinForNotFull(lock);
+            ++m_numWaitingPushers;
+            const bool isReady = m_cv_notFull.wait_until(lock, deadline, [this]{return isNotFullOrClosed();});
+            --m_numWaitingPushers;
+            m_stats.recordProducerBlock(blockStart);
+            return isReady;
+        }
+
+        /**
+         * @brief Block the caller until the queue is not-empty or drained. Must be called with `lock` locked, and returns with it locked.
+         */
+        void waitForNotEmpty(std::unique_lock<std::mutex> &lock) {
+            if (isNotEmptyOrClosed()) {
+                return;
+            }
+            const auto blockStart = m_stats.startBlock();
+            spinForNotEmpty(lock);
+            ++m_numWaitingPoppers;
+            while (!isNotEmptyOrClosed()) {
+                m_cv_notEmpty.wait(lock);
+                onPopperWokenLocked();
+            }
+            --m_numWaitingPoppers;
+            m_stats.recordConsumerBlock(blockStart);
+        }
+
+        /**
+         * @brief Block the caller until the queue is not-empty or drained, or `deadline` passes. Must be called with `lock` locked, and returns with it locked.
+         *
+         * @retval true The queue is not-empty or drained.
+         * @retval false `deadline` passed.
+         */
+        template <typename T_clock, typename T_duration>
+        bool waitForNotEmptyUntil(std::unique_lock<std::mutex> &lock, const std::chrono::time_point<T_clock, T_duration> &deadline) {
+            if (isNotEmptyOrClosed()) {
+                return true;
+            }
+            const auto blockStart = m_stats.startBlock();
+            spinForNotEmpty(lock);
+            ++m_numWaitingPoppers;
+            bool isReady = true;
+            while (!isNotEmptyOrClosed()) {
+                const bool isTimedOut = (m_cv_notEmpty.wait_until(lock, deadline) == std::cv_status::timeout);
+                onPopperWokenLocked();
+                if (isTimedOut) {
+                    isReady = isNotEmptyOrClosed();
+                    break;
+                }
+            }
+            --m_numWaitingPoppers;
+            m_stats.recordConsumerBlock(blockStart);
+            return isReady;
+        }
+
+        /**
+         * @brief Make room for a new element according to the overflow policy. Must be called with `m_mtx` locked.
+         *
+         * @details Under `OverflowPolicy::DROP_OLDEST`, the oldest visible element is dropped only if that frees a slot, i.e. no older slot is still borrowed; otherwise the new element is dropped instead. Either way exactly one element is dropped.
+         *
+         * @retval true There is room for one element (possibly after dropping the oldest one).
+         * @retval false The queue is full, so the new element is to be dropped.
+         */
+        bool makeRoomLocked() {
+            if (m_queue.occupied() < m_capacity) {
+                return true;
+            }
+            assert(m_overflowPolicy != OverflowPolicy::BLOCK);
+            ++m_numDroppedElements;
+            if ((m_overflowPolicy == OverflowPolicy::DROP_OLDEST) && !m_queue.empty() && (m_queue.numBorrowed() == 0)) {
+                m_queue.pop();
+                publishSize();
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Construct an element at the end of the queue. Must be called with `m_mtx` locked and the queue not-full.
+         */
+        template <typename... T_args>
+        void emplaceLocked(T_args&&... args) {
+            m_queue.emplace(std::forward<T_args>(args)...);
+            serveAsyncWaitersLocked();
+            publishSize();
+            wakePoppersLocked();
+        }
+
+        /**
+         * @brief Move the front element out of the queue. Must be called with `m_mtx` locked and the queue not-empty.
+         */
+        void popLocked(T_elem &elem) {
+            elem = std::move(m_queue.front());
+            m_queue.pop();
+            serveAsyncWaitersLocked();
+            publishSize();
+            if (m_numWaitingPushers > 0) {
+                notifyOne(m_cv_notFull);
+            }
+        }
 
     public:
         /**
          * @brief Construct a new MultiThreadQueue object
          *
          * @param[in] capacity The max number of the elements which can be held in the queue, must be 1 or greater.
+         * @param[in] waitStrategy how blocked `push` and `pop` callings wait
+         * @param[in] overflowPolicy what `push` does when the queue is full
+         * @param[in] watermarks how many blocked `pop` callings are woken up for the backlog
          */
-        MultiThreadQueue(size_t capacity) : m_capacity(capacity) {
+        MultiThreadQueue(size_t capacity, WaitStrategy waitStrategy = WaitStrategy::BLOCK, OverflowPolicy overflowPolicy = OverflowPolicy::BLOCK, NotifyWatermarks watermarks = NotifyWatermarks()) : m_capacity(capacity), m_waitStrategy(waitStrategy), m_overflowPolicy(overflowPolicy), m_watermarks(watermarks), m_queue(capacity), m_stats(capacity) {
             assert(capacity > 0);
+            assert(watermarks.lowWatermark > 0);
         }
 
         /**
@@ -51,6 +557,16 @@ class MultiThreadQueue {
             return m_capacity;
         }
 
+        /**
+         * @brief Get the number of the elements dropped so far because of the overflow policy
+         *
+         * @return the number of the dropped elements
+         */
+        size_t numDroppedElements() {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            return m_numDroppedElements;
+        }
+
         /**
          * @brief Check if the inlet is closed
          *
@@ -63,59 +579,502 @@ class MultiThreadQueue {
         }
 
         /**
-         * @brief Push an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         * @brief Get the generation of the queue, which is incremented by every `reopenInlet`
+         *
+         * @return the generation, 0 until the queue is reopened for the first time
+         */
+        size_t generation() const {
+            return m_generation.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Get the occupancy and wait-time statistics without taking the lock
+         *
+         * @return the statistics, which are all zero unless `T_stats` is `QueueStats`
+         */
+        QueueStatsSnapshot stats() const {
+            return m_stats.snapshot();
+        }
+
+        /**
+         * @brief Check if `pop` would return without blocking, that is, the queue is not-empty or is closed (and drained).
+         *
+         * @retval true The queue is ready to pop.
+         * @retval false The queue is empty and open.
+         */
+        bool isReadyToPop() {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            return isNotEmptyOrClosed();
+        }
+
+        /**
+         * @brief Register an observer to be told whenever the queue becomes not-empty or closed.
+         * @details If the queue is already ready to pop, the observer is told immediately.
+         *
+         * @param[in] observer the observer, which must outlive the registration
+         */
+        void addReadinessObserver(QueueReadinessObserver *observer) {
+            assert(observer != nullptr);
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_observers.push_back(observer);
+            if (isNotEmptyOrClosed()) {
+                observer->onReady();
+            }
+        }
+
+        /**
+         * @brief Unregister an observer registered by `addReadinessObserver`.
+         *
+         * @param[in] observer the observer
+         */
+        void removeReadinessObserver(QueueReadinessObserver *observer) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_observers.erase(std::remove(m_observers.begin(), m_observers.end(), observer), m_observers.end());
+        }
+
+        /**
+         * @brief Push a copy of an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
          *
          * @param[in] elem the data to be pushed into the queue
          * @retval true The data was successfully pushed into the queue.
-         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full, or the data was dropped (`OverflowPolicy::DROP_NEWEST`, or `DROP_OLDEST` while the oldest slot is borrowed).
+         */
+        bool push(const T_elem &elem) {
+            return emplace(elem);
+        }
+
+        /**
+         * @brief Move an element into the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         *
+         * @param[in] elem the data to be moved into the queue, which is left untouched if `false` is returned
+         * @retval true The data was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full, or the data was dropped (`OverflowPolicy::DROP_NEWEST`, or `DROP_OLDEST` while the oldest slot is borrowed).
+         */
+        bool push(T_elem &&elem) {
+            return emplace(std::move(elem));
+        }
+
+        /**
+         * @brief Construct an element in place at the end of the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         *
+         * @tparam T_args the types of the constructor arguments
+         * @param[in] args the arguments forwarded to the constructor of `T_elem`
+         * @retval true The element was successfully constructed in the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full, or the element was dropped (`OverflowPolicy::DROP_NEWEST`, or `DROP_OLDEST` while the oldest slot is borrowed). No element is constructed.
          */
-        bool push(T_elem elem) {
+        template <typename... T_args>
+        bool emplace(T_args&&... args) {
             std::unique_lock<std::mutex> lock(m_mtx);
-            m_cv_notFull.wait(lock, [this]{
-                return (m_queue.size() < m_capacity) || m_isInletClosed;
-            });
-            if (m_isInletClosed) {
+            waitForNotFull(lock);
+            if (m_isInletClosed || !makeRoomLocked()) {
                 return false;
             }
-            const bool isNotifNeeded = m_queue.empty();
-            m_queue.push(elem);
-            if (isNotifNeeded) {
-                m_cv_notEmpty.notify_one();
-            }
+            emplaceLocked(std::forward<T_args>(args)...);
             return true;
         }
 
         /**
          * @brief Pop an element from the queue. If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed.
          *
-         * @param[out] elem the reference to the data which the popped data to be stored
+         * @param[out] elem the reference to the data which the popped data to be moved into
          * @retval true The data was successfully popped from the queue.
          * @retval false The queue was already closed, or became closed during waiting for the queue to be not-empty.
          */
         bool pop(T_elem &elem) {
             std::unique_lock<std::mutex> lock(m_mtx);
-            m_cv_notEmpty.wait(lock, [this]{
-                return !m_queue.empty() || m_isInletClosed;
-            });
-            if (m_queue.empty() && m_isInletClosed) {
+            waitForNotEmpty(lock);
+            if (m_queue.empty()) {
                 return false;
             }
-            const bool isNotifNeeded = (m_queue.size() == m_capacity);
-            elem = m_queue.front();
-            m_queue.pop();
-            if (isNotifNeeded) {
-                m_cv_notFull.notify_one();
-            }
+            popLocked(elem);
             return true;
         }
 
+        /**
+         * @brief Push an element to the queue without blocking.
+         *
+         * @tparam T_arg the type of the element, which must be convertible to `T_elem`
+         * @param[in] elem the data to be pushed into the queue, which is left untouched unless `SUCCESS` is returned
+         * @retval QueueOpStatus::SUCCESS The data was pushed into the queue.
+         * @retval QueueOpStatus::CLOSED The queue was already closed.
+         * @retval QueueOpStatus::TIMEOUT The queue was full (`OverflowPolicy::BLOCK`).
+         * @retval QueueOpStatus::DROPPED The queue was full and the data was dropped (`OverflowPolicy::DROP_NEWEST`, or `DROP_OLDEST` while the oldest slot is borrowed).
+         */
+        template <typename T_arg>
+        QueueOpStatus tryPush(T_arg &&elem) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (m_isInletClosed) {
+                return QueueOpStatus::CLOSED;
+            }
+            if ((m_queue.occupied() >= m_capacity) && (m_overflowPolicy == OverflowPolicy::BLOCK)) {
+                return QueueOpStatus::TIMEOUT;
+            }
+            if (!makeRoomLocked()) {
+                return QueueOpStatus::DROPPED;
+            }
+            emplaceLocked(std::forward<T_arg>(elem));
+            return QueueOpStatus::SUCCESS;
+        }
+
+        /**
+         * @brief Push an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full, is closed, or `deadline` passes.
+         *
+         * @tparam T_arg the type of the element, which must be convertible to `T_elem`
+         * @tparam T_clock the clock of the deadline
+         * @tparam T_duration the duration type of the deadline
+         * @param[in] elem the data to be pushed into the queue, which is left untouched unless `SUCCESS` is returned
+         * @param[in] deadline the time point to give up
+         * @retval QueueOpStatus::SUCCESS The data was pushed into the queue.
+         * @retval QueueOpStatus::CLOSED The queue was already closed, or became closed during waiting for the queue to be not-full.
+         * @retval QueueOpStatus::TIMEOUT The queue was still full at `deadline`.
+         * @retval QueueOpStatus::DROPPED The queue was full and the data was dropped (`OverflowPolicy::DROP_NEWEST`, or `DROP_OLDEST` while the oldest slot is borrowed).
+         */
+        template <typename T_arg, typename T_clock, typename T_duration>
+        QueueOpStatus pushUntil(T_arg &&elem, const std::chrono::time_point<T_clock, T_duration> &deadline) {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            if (!waitForNotFullUntil(lock, deadline)) {
+                return QueueOpStatus::TIMEOUT;
+            }
+            if (m_isInletClosed) {
+                return QueueOpStatus::CLOSED;
+            }
+            if (!makeRoomLocked()) {
+                return QueueOpStatus::DROPPED;
+            }
+            emplaceLocked(std::forward<T_arg>(elem));
+            return QueueOpStatus::SUCCESS;
+        }
+
+        /**
+         * @brief Push an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full, is closed, or `timeout` elapses.
+         *
+         * @param[in] elem the data to be pushed into the queue, which is left untouched unless `SUCCESS` is returned
+         * @param[in] timeout the max time to wait
+         * @return the same as `pushUntil`
+         */
+        template <typename T_arg, typename T_rep, typename T_period>
+        QueueOpStatus pushFor(T_arg &&elem, const std::chrono::duration<T_rep, T_period> &timeout) {
+            return pushUntil(std::forward<T_arg>(elem), std::chrono::steady_clock::now() + timeout);
+        }
+
+        /**
+         * @brief Pop an element from the queue without blocking.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @retval QueueOpStatus::SUCCESS The data was popped from the queue.
+         * @retval QueueOpStatus::CLOSED The queue was closed and empty.
+         * @retval QueueOpStatus::TIMEOUT The queue was empty (but not closed).
+         */
+        QueueOpStatus tryPop(T_elem &elem) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (m_queue.empty()) {
+                return isDrainedLocked() ? QueueOpStatus::CLOSED : QueueOpStatus::TIMEOUT;
+            }
+            popLocked(elem);
+            return QueueOpStatus::SUCCESS;
+        }
+
+        /**
+         * @brief Pop an element from the queue. If the queue is empty, the caller thread is blocked until the queue is not-empty, is closed, or `deadline` passes.
+         *
+         * @tparam T_clock the clock of the deadline
+         * @tparam T_duration the duration type of the deadline
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @param[in] deadline the time point to give up
+         * @retval QueueOpStatus::SUCCESS The data was popped from the queue.
+         * @retval QueueOpStatus::CLOSED The queue was already closed, or became closed during waiting for the queue to be not-empty, and it is empty.
+         * @retval QueueOpStatus::TIMEOUT The queue was still empty at `deadline`.
+         */
+        template <typename T_clock, typename T_duration>
+        QueueOpStatus popUntil(T_elem &elem, const std::chrono::time_point<T_clock, T_duration> &deadline) {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            if (!waitForNotEmptyUntil(lock, deadline)) {
+                return QueueOpStatus::TIMEOUT;
+            }
+            if (m_queue.empty()) {
+                return QueueOpStatus::CLOSED;
+            }
+            popLocked(elem);
+            return QueueOpStatus::SUCCESS;
+        }
+
+        /**
+         * @brief Pop an element from the queue. If the queue is empty, the caller thread is blocked until the queue is not-empty, is closed, or `timeout` elapses.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @param[in] timeout the max time to wait
+         * @return the same as `popUntil`
+         */
+        template <typename T_rep, typename T_period>
+        QueueOpStatus popFor(T_elem &elem, const std::chrono::duration<T_rep, T_period> &timeout) {
+            return popUntil(elem, std::chrono::steady_clock::now() + timeout);
+        }
+
+        /**
+         * @brief Push elements in the range [first, last) to the queue under a single lock acquisition.
+         * @details If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         * Then as many elements as the free space allows are moved into the queue, and the waiting consumers are notified once.
+         * The caller pushes the rest (if any) by calling this method again from `first + returned value`.
+         * Under `OverflowPolicy::DROP_OLDEST` or `OverflowPolicy::DROP_NEWEST`, the whole range is taken at once and overflowing elements are dropped according to the policy.
+         *
+         * @tparam T_inputIt input iterator type whose value type is convertible to `T_elem`
+         * @param[in] first the beginning of the range
+         * @param[in] last the end of the range
+         * @return the number of the elements taken from the range (pushed, or dropped under a drop policy), which is 0 if the queue was already closed, or became closed during waiting for the queue to be not-full
+         */
+        template <typename T_inputIt>
+        size_t pushBulk(T_inputIt first, T_inputIt last) {
+            if (first == last) {
+                return 0;
+            }
+            std::unique_lock<std::mutex> lock(m_mtx);
+            waitForNotFull(lock);
+            if (m_isInletClosed) {
+                return 0;
+            }
+            size_t numTaken = 0;
+            for (; first != last; ++first, ++numTaken) {
+                if ((m_queue.occupied() >= m_capacity) && (m_overflowPolicy == OverflowPolicy::BLOCK)) {
+                    break;
+                }
+                if (makeRoomLocked()) {
+                    m_queue.emplace(std::move(*first));
+                }
+            }
+            serveAsyncWaitersLocked();
+            publishSize();
+            wakePoppersLocked();
+            return numTaken;
+        }
+
+        /**
+         * @brief Pop up to `maxCount` elements from the queue under a single lock acquisition.
+         * @details If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed.
+         * Then up to `maxCount` elements are moved to `out`, and the waiting producers are notified once.
+         *
+         * @tparam T_outputIt output iterator type which accepts `T_elem`
+         * @param[out] out the destination of the popped elements
+         * @param[in] maxCount the max number of the elements to be popped
+         * @return the number of the popped elements, which is 0 if the queue was already closed, or became closed during waiting for the queue to be not-empty (or if `maxCount` is 0)
+         */
+        template <typename T_outputIt>
+        size_t popBulk(T_outputIt out, size_t maxCount) {
+            if (maxCount == 0) {
+                return 0;
+            }
+            std::unique_lock<std::mutex> lock(m_mtx);
+            waitForNotEmpty(lock);
+            const size_t numPopped = std::min(maxCount, m_queue.size());
+            for (size_t i=0; i<numPopped; ++i) {
+                *out = std::move(m_queue.front());
+                ++out;
+                m_queue.pop();
+            }
+            serveAsyncWaitersLocked();
+            publishSize();
+            notifyN(m_cv_notFull, numPopped, m_numWaitingPushers);
+            return numPopped;
+        }
+
+        /**
+         * @brief Pop up to `maxCount` elements from the queue without blocking, under a single lock acquisition.
+         * @details Suited to event loops which are woken up by a readiness observer (e.g. `QueueEventFd`) and drain the queue in batches.
+         *
+         * @tparam T_outputIt output iterator type which accepts `T_elem`
+         * @param[out] out the destination of the popped elements
+         * @param[in] maxCount the max number of the elements to be popped
+         * @return the number of the popped elements, which is 0 if the queue was empty
+         */
+        template <typename T_outputIt>
+        size_t tryPopBulk(T_outputIt out, size_t maxCount) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            const size_t numPopped = std::min(maxCount, m_queue.size());
+            for (size_t i=0; i<numPopped; ++i) {
+                *out = std::move(m_queue.front());
+                ++out;
+                m_queue.pop();
+            }
+            serveAsyncWaitersLocked();
+            publishSize();
+            notifyN(m_cv_notFull, numPopped, m_numWaitingPushers);
+            return numPopped;
+        }
+
+#if defined(__cpp_impl_coroutine)
+        /**
+         * @brief awaitable returned by `asyncPop`
+         */
+        class AsyncPopAwaiter {
+            private:
+                MultiThreadQueue &m_queue;
+                AsyncPopWaiter m_waiter;
+
+            public:
+                AsyncPopAwaiter(MultiThreadQueue &queue, CoroutineExecutor &executor) : m_queue(queue), m_waiter{nullptr, executor, nullptr, std::nullopt} {}
+                AsyncPopAwaiter(const AsyncPopAwaiter &) = delete;
+                AsyncPopAwaiter &operator=(const AsyncPopAwaiter &) = delete;
+
+                bool await_ready() const noexcept {return false;}
+                bool await_suspend(std::coroutine_handle<> handle) {return m_queue.suspendAsyncPopper(m_waiter, handle);}
+                std::optional<T_elem> await_resume() {return std::move(m_waiter.elem);}
+        };
+
+        /**
+         * @brief awaitable returned by `asyncPush`
+         */
+        class AsyncPushAwaiter {
+            private:
+                MultiThreadQueue &m_queue;
+                T_elem m_elem;
+                AsyncPushWaiter m_waiter;
+
+            public:
+                AsyncPushAwaiter(MultiThreadQueue &queue, T_elem elem, CoroutineExecutor &executor) : m_queue(queue), m_elem(std::move(elem)), m_waiter{nullptr, executor, nullptr, &m_elem, false} {}
+                AsyncPushAwaiter(const AsyncPushAwaiter &) = delete;
+                AsyncPushAwaiter &operator=(const AsyncPushAwaiter &) = delete;
+
+                bool await_ready() const noexcept {return false;}
+                bool await_suspend(std::coroutine_handle<> handle) {return m_queue.suspendAsyncPusher(m_waiter, handle);}
+                bool await_resume() const noexcept {return m_waiter.isPushed;}
+        };
+
+        /**
+         * @brief Pop an element from a coroutine: `std::optional<T_elem> elem = co_await queue.asyncPop(executor);`
+         * @details If the queue is empty, the coroutine is suspended (no thread is blocked) in an intrusive list in its own frame, and is resumed by `executor` when an element is handed over to it or the queue is drained.
+         * Otherwise the coroutine goes on without being suspended.
+         * Coroutines and threads can push and pop the same queue. C++20 only.
+         *
+         * @param[in] executor the executor which resumes the coroutine, which must outlive the suspension
+         * @return awaitable which yields the popped element, or `std::nullopt` if the queue was already closed, or became closed during waiting for the queue to be not-empty
+         */
+        AsyncPopAwaiter asyncPop(CoroutineExecutor &executor) {
+            return AsyncPopAwaiter(*this, executor);
+        }
+
+        /**
+         * @brief Push an element from a coroutine: `bool isPushed = co_await queue.asyncPush(elem, executor);`
+         * @details If the queue is full, the coroutine is suspended (no thread is blocked) in an intrusive list in its own frame, and is resumed by `executor` when its element is taken in or the queue is closed.
+         * Otherwise the coroutine goes on without being suspended. C++20 only.
+         *
+         * @param[in] elem the data to be pushed into the queue
+         * @param[in] executor the executor which resumes the coroutine, which must outlive the suspension
+         * @return awaitable which yields `true` if the data was pushed, or `false` if the queue was already closed, or became closed during waiting for the queue to be not-full, or the element was dropped (`OverflowPolicy::DROP_NEWEST`)
+         */
+        AsyncPushAwaiter asyncPush(T_elem elem, CoroutineExecutor &executor) {
+            return AsyncPushAwaiter(*this, std::move(elem), executor);
+        }
+#endif
+
+        /**
+         * @brief Reserve a slot at the end of the queue and construct an element in it, to be filled in place. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         * @details Available only with `RingStoragePolicy`. The element stays invisible to consumers until `commit` is called, and the lock is not held in the meantime.
+         * Elements claimed by different producers become visible in the claim order: an element committed early waits for the ones claimed before it.
+         * Without arguments the element is default-initialized, so a trivial payload (e.g. `std::array<float, N>`) is not zero-filled.
+         *
+         * @tparam T_args the types of the constructor arguments
+         * @param[in] args the arguments forwarded to the constructor of `T_elem`
+         * @return pointer to the element, which must be passed to `commit` exactly once, or `nullptr` if the queue was already closed, or became closed during waiting for the queue to be not-full, or the element was dropped (`OverflowPolicy::DROP_NEWEST`)
+         */
+        template <typename... T_args>
+        T_elem *claim(T_args&&... args) {
+            static_assert(std::is_same_v<T_storagePolicy, RingStoragePolicy>, "claim/commit requires RingStoragePolicy");
+            std::unique_lock<std::mutex> lock(m_mtx);
+            waitForNotFull(lock);
+            if (m_isInletClosed || !makeRoomLocked()) {
+                return nullptr;
+            }
+            T_elem *const slot = m_queue.claim(std::forward<T_args>(args)...); // If the constructor throws, nothing is claimed.
+            ++m_numClaimedSlots;
+            return slot;
+        }
+
+        /**
+         * @brief Make a claimed element visible to consumers.
+         * @details The element may be committed even after the inlet is closed; it is still popped before `pop` starts returning `false`.
+         *
+         * @param[in] slot the pointer returned by `claim`
+         */
+        void commit(T_elem *slot) {
+            static_assert(std::is_same_v<T_storagePolicy, RingStoragePolicy>, "claim/commit requires RingStoragePolicy");
+            assert(slot != nullptr);
+            std::lock_guard<std::mutex> lock(m_mtx);
+            --m_numClaimedSlots;
+            const size_t numPublished = m_queue.commit(slot);
+            serveAsyncWaitersLocked();
+            publishSize();
+            if (isDrainedLocked()) {
+                notifyAllPoppers();
+                notifyObserversLocked();
+            } else if (numPublished > 0) {
+                wakePoppersLocked();
+            }
+        }
+
+        /**
+         * @brief Take the front element to be read in place. If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed.
+         * @details Available only with `RingStoragePolicy`. The slot is not reused until `release` is called, and the lock is not held in the meantime.
+         *
+         * @return pointer to the element, which must be passed to `release` exactly once, or `nullptr` if the queue was already closed, or became closed during waiting for the queue to be not-empty
+         */
+        T_elem *borrow() {
+            static_assert(std::is_same_v<T_storagePolicy, RingStoragePolicy>, "borrow/release requires RingStoragePolicy");
+            std::unique_lock<std::mutex> lock(m_mtx);
+            waitForNotEmpty(lock);
+            if (m_queue.empty()) {
+                return nullptr;
+            }
+            T_elem *const slot = m_queue.borrow();
+            publishSize();
+            return slot;
+        }
+
+        /**
+         * @brief Destroy a borrowed element and recycle its slot.
+         *
+         * @param[in] slot the pointer returned by `borrow`
+         */
+        void release(T_elem *slot) {
+            static_assert(std::is_same_v<T_storagePolicy, RingStoragePolicy>, "borrow/release requires RingStoragePolicy");
+            assert(slot != nullptr);
+            std::lock_guard<std::mutex> lock(m_mtx);
+            const size_t numFreed = m_queue.release(slot);
+            serveAsyncWaitersLocked();
+            notifyN(m_cv_notFull, numFreed, m_numWaitingPushers);
+        }
+
+        /**
+         * @brief Take all the elements out of the queue and return them to the caller, in FIFO order.
+         * @details With `DequeStoragePolicy`, the storage is swapped with an empty one allocated before locking, so the lock is held for a constant time regardless of the number of the elements.
+         * The caller can requeue, persist or destroy the elements without blocking the other threads.
+         * With `RingStoragePolicy`, the elements are moved out one by one under the lock (no deallocation happens under the lock, though).
+         * Claimed or borrowed slots are not taken.
+         *
+         * @return the elements which were in the queue
+         */
+        std::deque<T_elem> drain() {
+            std::deque<T_elem> drained;
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if constexpr (std::is_same_v<T_storagePolicy, DequeStoragePolicy>) {
+                m_queue.swapElements(drained);
+            } else {
+                while (!m_queue.empty()) {
+                    drained.push_back(std::move(m_queue.front()));
+                    m_queue.pop();
+                }
+            }
+            serveAsyncWaitersLocked();
+            publishSize();
+            notifyN(m_cv_notFull, drained.size(), m_numWaitingPushers);
+            return drained;
+        }
+
         /**
          * @brief Pop all elements from the queue.
          * @details One typically uses this method to abort pending tasks under producer-consumer thread model; calls `closeInlet` method, then calls `popAll` method.
+         * The elements are taken by `drain` and destroyed after the lock is released.
          */
         void popAll() {
-            std::lock_guard<std::mutex> lock(m_mtx);
-            while (!m_queue.empty()) {m_queue.pop();}
+            drain();
         }
 
         /**
@@ -127,9 +1086,34 @@ class MultiThreadQueue {
         void closeInlet() {
             std::lock_guard<std::mutex> lock(m_mtx);
             m_isInletClosed = true;
-            m_cv_notFull.notify_all();
-            m_cv_notEmpty.notify_all();
+            serveAsyncWaitersLocked();
+            notifyAll(m_cv_notFull);
+            notifyAllPoppers();
+            notifyObserversLocked();
         }
+
+        /**
+         * @brief Reopen the closed queue inlet and start a new generation, so that the queue, its storage and its observers can be used again.
+         * @details The elements left in the queue are kept. Does nothing if the inlet is open.
+         * A thread blocked in `pop` which has not observed the closure yet keeps waiting in the new generation,
+         * so consumers which rely on the closure to stop must have returned from `pop` before this method is called.
+         */
+        void reopenInlet() {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (!m_isInletClosed) {
+                return;
+            }
+            m_isInletClosed = false;
+            m_generation.fetch_add(1, std::memory_order_release);
+        }
+};
+
+/**
+ * @brief queue policy to build containers (e.g. `BasicThreadPool`) on `MultiThreadQueue`
+ */
+struct MutexQueuePolicy {
+    template <typename T_elem>
+    using Queue = MultiThreadQueue<T_elem>;
 };
 
 #endif // __MULTI_THREAD_QUEUE__
@@ -0,0 +1,354 @@
+/**
+ * @file ParallelLoop.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief index-range loops split over a thread pool by lazy binary splitting, the engine of `BasicThreadPool::parallelFor`/`parallelReduce`
+ * @version 0.2.2
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __PARALLEL_LOOP__
+#define __PARALLEL_LOOP__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ConcurrencyUtil.hpp"
+#include "EventCount.hpp"
+
+/**
+ * @brief half-open index range [begin, end)
+ */
+struct IndexRange {
+    size_t begin;
+    size_t end;
+
+    size_t size() const {return end - begin;}
+};
+
+/**
+ * @brief options of `BasicThreadPool::parallelFor`/`parallelReduce`
+ */
+struct ParallelOptions {
+    size_t grainSize = 0; // the number of indices the body is called with at a time (the last chunk may be shorter); 0 chooses about 8 chunks per participating thread
+    bool isDeterministic = false; // `parallelReduce` only: combine the partial results in index order, so the result does not depend on scheduling (for a fixed `grainSize`)
+};
+
+/**
+ * @brief one parallel loop over an index range, shared by the caller thread and the pooled threads which help it
+ * @details The range is divided into chunks of `grainSize` indices, aligned to the beginning of the range.
+ * A participant runs its piece chunk by chunk, and splits the rest of the piece in half only when no other piece is waiting to be claimed (lazy binary splitting):
+ * one pool task is posted per split-off piece, so the loop spreads as fast as threads become free, but costs nothing more than a sequential loop when they are busy.
+ * The caller thread takes part and, after its own piece, claims the pieces which no pooled thread has started, so the loop also finishes when the pool is busy with other tasks.
+ * Pool tasks which start after the loop has finished find nothing to claim; they keep the object alive by `std::shared_ptr`.
+ *
+ * @tparam T_kernel what is done per chunk, with `Local makeLocal()`, `void runChunk(Local &, IndexRange chunk, size_t chunkIndex)` and `void finishLocal(Local &)`
+ */
+template <typename T_kernel>
+class ParallelLoop : public std::enable_shared_from_this<ParallelLoop<T_kernel>> {
+    private:
+        using Local = decltype(std::declval<T_kernel &>().makeLocal());
+
+        T_kernel m_kernel;
+        const size_t m_begin;
+        const size_t m_grainSize;
+        std::mutex m_piecesMtx;
+        std::vector<IndexRange> m_pieces; // the pieces split off and not claimed yet, guarded by `m_piecesMtx`
+        std::atomic<size_t> m_numPieces{0}; // `m_pieces.size()`, read without the lock to decide to split
+        std::atomic<size_t> m_numRemaining; // the number of the indices not run yet
+        EventCount m_ec_done; // notified when the last index has run or a piece is split off
+        std::atomic<bool> m_isFailed{false};
+        std::exception_ptr m_exception; // the first exception thrown by the kernel, written once before `m_isFailed` is set
+
+        bool claimPiece(IndexRange &piece) {
+            if (m_numPieces.load(std::memory_order_acquire) == 0) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(m_piecesMtx);
+            if (m_pieces.empty()) {
+                return false;
+            }
+            piece = m_pieces.back();
+            m_pieces.pop_back();
+            m_numPieces.store(m_pieces.size(), std::memory_order_release);
+            return true;
+        }
+
+        template <typename T_pool>
+        void splitOff(T_pool &pool, IndexRange piece) {
+            {
+                std::lock_guard<std::mutex> lock(m_piecesMtx);
+                m_pieces.push_back(piece);
+                m_numPieces.store(m_pieces.size(), std::memory_order_release);
+            }
+            m_ec_done.notifyAll(); // for the caller waiting in `run`
+            /* The helper task claims whichever piece is waiting when it starts, if any. If the pool is closed or full, the piece waits for the threads already in the loop. */
+            pool.tryPost([self = this->shared_from_this(), &pool]{
+                IndexRange claimed;
+                if (self->claimPiece(claimed)) {
+                    self->participate(pool, claimed);
+                }
+            });
+        }
+
+        void recordException() {
+            std::lock_guard<std::mutex> lock(m_piecesMtx);
+            if (!m_exception) {
+                m_exception = std::current_exception();
+                m_isFailed.store(true, std::memory_order_release);
+            }
+        }
+
+        /**
+         * @brief Count down the indices run (or skipped) by a participant, after its partial result has been finished.
+         */
+        void finish(size_t numIndices) {
+            if (m_numRemaining.fetch_sub(numIndices, std::memory_order_acq_rel) == numIndices) {
+                m_ec_done.notifyAll();
+            }
+        }
+
+        /**
+         * @brief Run a piece, splitting off its second half whenever no other piece is waiting to be claimed.
+         *
+         * @return the number of the indices which this call is responsible for, i.e. the piece less the split-off pieces
+         */
+        template <typename T_pool>
+        size_t runPiece(T_pool &pool, IndexRange piece, Local &local) {
+            const size_t pieceBegin = piece.begin;
+            try {
+                while (!m_isFailed.load(std::memory_order_relaxed) && (piece.size() > m_grainSize)) {
+                    if (m_numPieces.load(std::memory_order_relaxed) == 0) {
+                        const size_t numChunks = (piece.size() + m_grainSize - 1)/m_grainSize;
+                        const size_t mid = piece.begin + (numChunks/2)*m_grainSize;
+                        splitOff(pool, IndexRange{mid, piece.end}); // The split-off indices are counted down by whoever claims them.
+                        piece.end = mid;
+                        continue;
+                    }
+                    m_kernel.runChunk(local, IndexRange{piece.begin, piece.begin + m_grainSize}, (piece.begin - m_begin)/m_grainSize);
+                    piece.begin += m_grainSize;
+                }
+                if (!m_isFailed.load(std::memory_order_relaxed) && (piece.size() > 0)) {
+                    m_kernel.runChunk(local, piece, (piece.begin - m_begin)/m_grainSize);
+                }
+            } catch (...) {
+                recordException();
+            }
+            return piece.end - pieceBegin; // run, or skipped after a failure
+        }
+
+        /**
+         * @brief Run the given piece, then the pieces claimed one after another, and finish the partial result.
+         */
+        template <typename T_pool>
+        void participate(T_pool &pool, IndexRange piece) {
+            size_t numIndices = 0;
+            Local local = m_kernel.makeLocal();
+            do {
+                numIndices += runPiece(pool, piece, local);
+            } while (claimPiece(piece));
+            try {
+                m_kernel.finishLocal(local);
+            } catch (...) {
+                recordException();
+            }
+            finish(numIndices);
+        }
+
+    public:
+        /**
+         * @brief Construct a new ParallelLoop object
+         *
+         * @param[in] range the whole index range, must not be empty
+         * @param[in] grainSize the chunk size, must be 1 or greater
+         * @param[in] kernelArgs the arguments forwarded to the constructor of `T_kernel`
+         */
+        template <typename... T_kernelArgs>
+        ParallelLoop(IndexRange range, size_t grainSize, T_kernelArgs&&... kernelArgs) : m_kernel(std::forward<T_kernelArgs>(kernelArgs)...), m_begin(range.begin), m_grainSize(grainSize), m_numRemaining(range.size()) {}
+
+        /**
+         * @brief Run the whole range with the help of the pooled threads of `pool`, and return when every index has run. Called once by the owner of the loop.
+         *
+         * @tparam T_pool thread pool type with `tryPost`
+         * @param[in] range the whole index range given to the constructor
+         * @throw the first exception thrown by the kernel, after every participant has stopped
+         */
+        template <typename T_pool>
+        void run(T_pool &pool, IndexRange range) {
+            participate(pool, range);
+            /* Help with the pieces split off later by the others, which no pooled thread may be free to claim. */
+            for (;;) {
+                m_ec_done.wait([this]{return (m_numRemaining.load(std::memory_order_acquire) == 0) || (m_numPieces.load(std::memory_order_acquire) > 0);});
+                IndexRange piece;
+                if (claimPiece(piece)) {
+                    participate(pool, piece);
+                } else if (m_numRemaining.load(std::memory_order_acquire) == 0) {
+                    break;
+                }
+            }
+            if (m_isFailed.load(std::memory_order_acquire)) {
+                std::rethrow_exception(m_exception);
+            }
+        }
+
+        /**
+         * @brief Get the kernel, e.g. to read its result after `run`.
+         */
+        T_kernel &kernel() {return m_kernel;}
+};
+
+/**
+ * @brief Call a loop body on a chunk: once with the chunk if it takes `IndexRange`, otherwise once per index.
+ */
+template <typename T_body>
+void runLoopBody(T_body &body, IndexRange chunk) {
+    if constexpr (std::is_invocable_v<T_body &, IndexRange>) {
+        body(chunk);
+    } else {
+        for (size_t i=chunk.begin; i<chunk.end; ++i) {
+            body(i);
+        }
+    }
+}
+
+/**
+ * @brief Get the partial result of a reduction body on a chunk: returned by the body if it takes `IndexRange`, otherwise combined from the results per index.
+ */
+template <typename T_value, typename T_body, typename T_combine>
+T_value reduceLoopBody(T_body &body, T_combine &combine, const T_value &identity, IndexRange chunk) {
+    if constexpr (std::is_invocable_v<T_body &, IndexRange>) {
+        return body(chunk);
+    } else {
+        T_value partial = identity;
+        for (size_t i=chunk.begin; i<chunk.end; ++i) {
+            partial = combine(std::move(partial), body(i));
+        }
+        return partial;
+    }
+}
+
+/**
+ * @brief `ParallelLoop` kernel of `parallelFor`
+ */
+template <typename T_body>
+struct ParallelForKernel {
+    struct Local {};
+
+    T_body &body;
+
+    explicit ParallelForKernel(T_body &b) : body(b) {}
+    Local makeLocal() {return Local{};}
+    void runChunk(Local &, IndexRange chunk, size_t) {runLoopBody(body, chunk);}
+    void finishLocal(Local &) {}
+};
+
+/**
+ * @brief `ParallelLoop` kernel of `parallelReduce` which folds the chunks of each participant, then the participants in the order they finish
+ */
+template <typename T_value, typename T_body, typename T_combine>
+struct UnorderedReduceKernel {
+    T_body &body;
+    T_combine &combine;
+    const T_value identity;
+    std::mutex mtx;
+    T_value result; // guarded by `mtx`
+
+    UnorderedReduceKernel(T_body &b, T_combine &c, const T_value &id) : body(b), combine(c), identity(id), result(id) {}
+    T_value makeLocal() {return identity;}
+    void runChunk(T_value &local, IndexRange chunk, size_t) {local = combine(std::move(local), reduceLoopBody(body, combine, identity, chunk));}
+
+    void finishLocal(T_value &local) {
+        std::lock_guard<std::mutex> lock(mtx);
+        result = combine(std::move(result), std::move(local));
+    }
+};
+
+/**
+ * @brief `ParallelLoop` kernel of `parallelReduce` which keeps the partial result of every chunk, to be folded in index order after the loop
+ */
+template <typename T_value, typename T_body, typename T_combine>
+struct OrderedReduceKernel {
+    struct Local {};
+
+    /**
+     * @brief the partial result of a chunk, in a cache line of its own: the chunks are written concurrently, which `std::vector<bool>` could not take, and neighbouring chunks would falsely share a line
+     */
+    struct alignas(CACHE_LINE_SIZE) Partial {
+        T_value value;
+    };
+
+    T_body &body;
+    T_combine &combine;
+    const T_value identity;
+    std::vector<Partial> partials; // one per chunk, each written by the participant which runs the chunk
+
+    OrderedReduceKernel(T_body &b, T_combine &c, const T_value &id, size_t numChunks) : body(b), combine(c), identity(id), partials(numChunks, Partial{id}) {}
+    Local makeLocal() {return Local{};}
+    void runChunk(Local &, IndexRange chunk, size_t chunkIndex) {partials[chunkIndex].value = reduceLoopBody(body, combine, identity, chunk);}
+    void finishLocal(Local &) {}
+};
+
+/**
+ * @brief Choose the chunk size for a range of `numIndices` indices run by `numThreads` pooled threads and the caller thread.
+ */
+inline size_t chooseGrainSize(const ParallelOptions &options, size_t numIndices, size_t numThreads) {
+    if (options.grainSize > 0) {
+        return options.grainSize;
+    }
+    return std::max<size_t>(1, numIndices/(8*(numThreads + 1)));
+}
+
+/**
+ * @brief Call `body` for every index of `range`, in parallel on the caller thread and the pooled threads of `pool` (with `tryPost`). See `BasicThreadPool::parallelFor`.
+ */
+template <typename T_pool, typename T_body>
+void parallelFor(T_pool &pool, IndexRange range, T_body &body, const ParallelOptions &options) {
+    if (range.end <= range.begin) {
+        return;
+    }
+    const size_t grainSize = chooseGrainSize(options, range.size(), pool.numThreads());
+    if (range.size() <= grainSize) {
+        runLoopBody(body, range);
+        return;
+    }
+    auto loop = std::make_shared<ParallelLoop<ParallelForKernel<T_body>>>(range, grainSize, body);
+    loop->run(pool, range);
+}
+
+/**
+ * @brief Reduce the results of `body` over `range` with `combine`, in parallel on the caller thread and the pooled threads of `pool`. See `BasicThreadPool::parallelReduce`.
+ */
+template <typename T_pool, typename T_value, typename T_body, typename T_combine>
+T_value parallelReduce(T_pool &pool, IndexRange range, const T_value &identity, T_body &body, T_combine &combine, const ParallelOptions &options) {
+    if (range.end <= range.begin) {
+        return identity;
+    }
+    const size_t grainSize = chooseGrainSize(options, range.size(), pool.numThreads());
+    if (range.size() <= grainSize) {
+        return combine(identity, reduceLoopBody(body, combine, identity, range));
+    }
+    if (options.isDeterministic) {
+        const size_t numChunks = (range.size() + grainSize - 1)/grainSize;
+        auto loop = std::make_shared<ParallelLoop<OrderedReduceKernel<T_value, T_body, T_combine>>>(range, grainSize, body, combine, identity, numChunks);
+        loop->run(pool, range);
+        T_value result = identity;
+        for (auto &partial : loop->kernel().partials) {
+            result = combine(std::move(result), std::move(partial.value));
+        }
+        return result;
+    }
+    auto loop = std::make_shared<ParallelLoop<UnorderedReduceKernel<T_value, T_body, T_combine>>>(range, grainSize, body, combine, identity);
+    loop->run(pool, range);
+    std::lock_guard<std::mutex> lock(loop->kernel().mtx);
+    return std::move(loop->kernel().result);
+}
+
+#endif // __PARALLEL_LOOP__
@@ -0,0 +1,290 @@
+/**
+ * @file PriorityMultiThreadQueue.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief bounded concurrent relaxed priority queue based on the MultiQueue design (Rihani, Sanders and Dementiev, 2015)
+ * @version 0.4.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __PRIORITY_MULTI_THREAD_QUEUE__
+#define __PRIORITY_MULTI_THREAD_QUEUE__
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ConcurrencyUtil.hpp"
+#include "EventCount.hpp"
+#include "QueueInlet.hpp"
+
+/**
+ * @brief bounded multi-producer multi-consumer priority queue
+ * @details Drop-in replacement of `MultiThreadQueue` (`push`/`pop`/`drain`/`popAll`/`closeInlet`) which pops high-priority elements first.
+ * The elements are spread over several binary heaps ("shards"), each with its own lock.
+ * `push` inserts into a random shard, and `pop` looks at the tops of two random shards and takes the higher one, so threads rarely contend on the same lock.
+ * The order is relaxed: `pop` returns an element close to, but not always exactly, the highest-priority one in the queue.
+ * Elements of equal priority are not ordered (no FIFO among them).
+ * Threads block (in `EventCount`) only when the queue is full or empty.
+ *
+ * @tparam T_elem the data type of elements
+ * @tparam T_compare strict weak ordering; `T_compare()(a, b)` is `true` if `a` has lower priority than `b` (as `std::priority_queue`)
+ */
+template <typename T_elem, typename T_compare = std::less<T_elem>>
+class PriorityMultiThreadQueue {
+    private:
+        static constexpr unsigned int NUM_TWO_CHOICE_TRIALS = 8; // two-choice trials before falling back to a full scan
+
+        struct alignas(CACHE_LINE_SIZE) Shard {
+            std::mutex mtx;
+            std::vector<T_elem> heap; // binary heap ordered by `T_compare`, guarded by `mtx`
+        };
+
+        const size_t m_capacity;
+        const size_t m_numShards;
+        const std::unique_ptr<Shard[]> m_shards;
+        const T_compare m_compare;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_numFreeSlots; // slots not reserved by any pusher
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_numAvailable{0}; // elements inserted and not reserved by any popper
+        alignas(CACHE_LINE_SIZE) QueueInlet m_inlet;
+        EventCount m_ec_notFull;
+        EventCount m_ec_notEmpty;
+
+        /**
+         * @brief Move the top of a locked shard out.
+         */
+        void popHeapLocked(Shard &shard, T_elem *elem) {
+            std::pop_heap(shard.heap.begin(), shard.heap.end(), m_compare);
+            if (elem != nullptr) {
+                *elem = std::move(shard.heap.back());
+            }
+            shard.heap.pop_back();
+        }
+
+        /**
+         * @brief Take an element whose existence has been reserved from `m_numAvailable`.
+         *
+         * @param[out] elem pointer to the data which the popped data to be stored, or `nullptr` to discard the popped data
+         */
+        void takeReserved(T_elem *elem) {
+            /* two-choice: the higher of the tops of two random shards */
+            for (unsigned int trial=0; (trial < NUM_TWO_CHOICE_TRIALS) && (m_numShards > 1); ++trial) {
+                Shard &a = m_shards[xorshiftRandom() % m_numShards];
+                Shard &b = m_shards[xorshiftRandom() % m_numShards];
+                if (&a == &b) {continue;}
+                std::unique_lock<std::mutex> lockA(a.mtx, std::try_to_lock);
+                if (!lockA.owns_lock()) {continue;}
+                std::unique_lock<std::mutex> lockB(b.mtx, std::try_to_lock);
+                if (!lockB.owns_lock()) {continue;}
+                Shard *best = nullptr;
+                if (!a.heap.empty()) {best = &a;}
+                if (!b.heap.empty() && ((best == nullptr) || m_compare(a.heap.front(), b.heap.front()))) {best = &b;}
+                if (best != nullptr) {
+                    popHeapLocked(*best, elem);
+                    return;
+                }
+            }
+            /* Fall back to scanning every shard. An element is guaranteed to be found since it was reserved. */
+            for (size_t start = xorshiftRandom() % m_numShards;; ++start) {
+                for (size_t k=0; k<m_numShards; ++k) {
+                    Shard &shard = m_shards[(start + k) % m_numShards];
+                    std::lock_guard<std::mutex> lock(shard.mtx);
+                    if (!shard.heap.empty()) {
+                        popHeapLocked(shard, elem);
+                        return;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Put an element, whose slot has been reserved from `m_numFreeSlots`, into the a random shard and wake a consumer.
+         */
+        void putReserved(T_elem elem) {
+            Shard &shard = m_shards[xorshiftRandom() % m_numShards];
+            {
+                std::lock_guard<std::mutex> lock(shard.mtx);
+                shard.heap.push_back(std::move(elem));
+                std::push_heap(shard.heap.begin(), shard.heap.end(), m_compare);
+            }
+            m_numAvailable.fetch_add(1, std::memory_order_seq_cst);
+            m_ec_notEmpty.notifyOne();
+        }
+
+    public:
+        /**
+         * @brief Construct a new PriorityMultiThreadQueue object
+         *
+         * @param[in] capacity The max number of the elements which can be held in the queue, must be 1 or greater.
+         * @param[in] numShards the number of the heaps, or 0 to use twice the number of the hardware threads
+         * @param[in] compare the ordering of the priorities
+         */
+        PriorityMultiThreadQueue(size_t capacity, size_t numShards = 0, T_compare compare = T_compare()) :
+            m_capacity(capacity),
+            m_numShards((numShards > 0) ? numShards : std::max(2u, 2*std::thread::hardware_concurrency())),
+            m_shards(new Shard[m_numShards]),
+            m_compare(std::move(compare)),
+            m_numFreeSlots(capacity)
+        {
+            assert(capacity > 0);
+        }
+
+        PriorityMultiThreadQueue(const PriorityMultiThreadQueue &) = delete;
+        PriorityMultiThreadQueue &operator=(const PriorityMultiThreadQueue &) = delete;
+
+        /**
+         * @brief Get the capacity of the queue
+         *
+         * @return capacity
+         */
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        /**
+         * @brief Check if the inlet is closed
+         *
+         * @retval true the inlet is closed
+         * @retval false the inlet is open
+         */
+        bool isInletClosed() const {
+            return m_inlet.isClosed();
+        }
+
+        /**
+         * @brief Get the generation of the queue, which is incremented by every `reopenInlet`
+         *
+         * @return the generation, 0 until the queue is reopened for the first time
+         */
+        size_t generation() const {
+            return m_inlet.generation();
+        }
+
+        /**
+         * @brief Push an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         *
+         * @param[in] elem the data to be pushed into the queue
+         * @retval true The data was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        bool push(T_elem elem) {
+            return m_inlet.push(m_ec_notFull, m_ec_notEmpty, [this]{return tryReserve(m_numFreeSlots);}, [&]{putReserved(std::move(elem));});
+        }
+
+        /**
+         * @brief Push an element to the queue without blocking.
+         *
+         * @param[in,out] elem the data to be moved into the queue, which is left untouched on failure
+         * @retval true The data was pushed into the queue.
+         * @retval false The queue was closed or full.
+         */
+        bool tryPush(T_elem &elem) {
+            return m_inlet.tryPush(m_ec_notEmpty, [this]{return tryReserve(m_numFreeSlots);}, [&]{putReserved(std::move(elem));});
+        }
+
+        /**
+         * @brief Pop a high-priority element from the queue. If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @retval true The data was successfully popped from the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-empty.
+         */
+        bool pop(T_elem &elem) {
+            bool isReserved = tryReserve(m_numAvailable);
+            if (!isReserved) {
+                m_ec_notEmpty.wait([&]{
+                    isReserved = tryReserve(m_numAvailable);
+                    if (isReserved) {
+                        return true;
+                    }
+                    if (m_inlet.isDrained()) {
+                        isReserved = tryReserve(m_numAvailable);
+                        return true;
+                    }
+                    return false;
+                });
+            }
+            if (!isReserved) {
+                return false;
+            }
+            takeReserved(&elem);
+            m_numFreeSlots.fetch_add(1, std::memory_order_seq_cst);
+            m_ec_notFull.notifyOne();
+            return true;
+        }
+
+        /**
+         * @brief Pop an element from the queue without blocking.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @retval true The data was popped from the queue.
+         * @retval false The queue was empty.
+         */
+        bool tryPop(T_elem &elem) {
+            if (!tryReserve(m_numAvailable)) {
+                return false;
+            }
+            takeReserved(&elem);
+            m_numFreeSlots.fetch_add(1, std::memory_order_seq_cst);
+            m_ec_notFull.notifyOne();
+            return true;
+        }
+
+        /**
+         * @brief Take all the elements out of the queue and return them to the caller, roughly in priority order.
+         * @details All the available elements are reserved at once, then taken shard by shard; each shard lock is held only to move one element out. `T_elem` must be default-constructible.
+         *
+         * @return the elements which were in the queue
+         */
+        std::deque<T_elem> drain() {
+            const size_t numReserved = m_numAvailable.exchange(0, std::memory_order_seq_cst);
+            std::deque<T_elem> drained(numReserved);
+            for (T_elem &elem : drained) {
+                takeReserved(&elem);
+            }
+            if (numReserved > 0) {
+                m_numFreeSlots.fetch_add(numReserved, std::memory_order_seq_cst);
+                m_ec_notFull.notifyAll();
+            }
+            return drained;
+        }
+
+        /**
+         * @brief Pop all elements from the queue.
+         * @details One typically uses this method to abort pending tasks under producer-consumer thread model; calls `closeInlet` method, then calls `popAll` method.
+         * The elements are taken by `drain` and destroyed without any shard lock held.
+         */
+        void popAll() {
+            drain();
+        }
+
+        /**
+         * @brief Close the queue inlet.
+         * @details After the queue inlet is closed:
+         * @par 1. Following or currently-blocked `push` callings return with `false`.
+         * @par 2. Following or currently-blocked `pop` callings return with `true` as far as there is at least one element in the queue, otherwise return with `false`.
+         */
+        void closeInlet() {
+            m_inlet.close();
+            m_ec_notFull.notifyAll();
+            m_ec_notEmpty.notifyAll();
+        }
+
+        /**
+         * @brief Reopen the closed queue inlet and start a new generation, so that the queue can be used again.
+         * @details The elements left in the queue are kept. See `QueueInlet::reopen` for the consumers still blocked in `pop`.
+         */
+        void reopenInlet() {
+            m_inlet.reopen();
+        }
+};
+
+#endif // __PRIORITY_MULTI_THREAD_QUEUE__
@@ -0,0 +1,102 @@
+/**
+ * @file QueueEventFd.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief eventfd which becomes readable when a `MultiThreadQueue` becomes ready to pop (Linux only)
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __QUEUE_EVENT_FD__
+#define __QUEUE_EVENT_FD__
+
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "MultiThreadQueue.hpp"
+
+/**
+ * @brief eventfd which becomes readable when the observed queue transitions to not-empty or closed
+ * @details Lets an epoll (or poll/select) loop consume a `MultiThreadQueue` on its own thread, without a bridging thread:
+ * @code
+ * QueueEventFd<MultiThreadQueue<Msg>> queueFd(queue);
+ * // register queueFd.fd() with EPOLLIN
+ * // on EPOLLIN:
+ * queueFd.clear();
+ * const bool isClosed = queue.isInletClosed(); // checked before draining, so that no element pushed before closing is left behind
+ * while ((n = queue.tryPopBulk(batch.begin(), batch.size())) > 0) {...}
+ * if (isClosed) {...} // unregister queueFd.fd() from the loop
+ * @endcode
+ * Call `clear` before draining: an element pushed after the queue was found empty makes the fd readable again.
+ * The queue writes the eventfd with its lock held, but only on the empty to not-empty transition (and on close), so a busy queue does not make a system call per element.
+ * Open failures throw `std::system_error`.
+ *
+ * @tparam T_queue the queue type, a `MultiThreadQueue`
+ */
+template <typename T_queue>
+class QueueEventFd : public QueueReadinessObserver {
+    private:
+        T_queue &m_queue;
+        const int m_fd;
+
+        static int openEventFd() {
+            const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "eventfd");
+            }
+            return fd;
+        }
+
+    public:
+        /**
+         * @brief Create an eventfd and register it to the queue.
+         * @details If the queue is already ready to pop, the fd is readable at once.
+         *
+         * @param[in] queue the queue to be observed, which must outlive this object
+         */
+        explicit QueueEventFd(T_queue &queue) : m_queue(queue), m_fd(openEventFd()) {
+            m_queue.addReadinessObserver(this);
+        }
+
+        QueueEventFd(const QueueEventFd &) = delete;
+        QueueEventFd &operator=(const QueueEventFd &) = delete;
+
+        /**
+         * @brief Unregister from the queue and close the eventfd.
+         */
+        ~QueueEventFd() {
+            m_queue.removeReadinessObserver(this);
+            close(m_fd);
+        }
+
+        /**
+         * @brief Get the file descriptor to be watched for readability
+         *
+         * @return the eventfd
+         */
+        int fd() const {
+            return m_fd;
+        }
+
+        /**
+         * @brief Make the fd non-readable. Call this before draining the queue.
+         */
+        void clear() {
+            uint64_t count;
+            while (read(m_fd, &count, sizeof(count)) < 0 && (errno == EINTR)) {}
+        }
+
+        /**
+         * @brief Called by the queue when it becomes ready.
+         */
+        void onReady() override {
+            const uint64_t one = 1;
+            while (write(m_fd, &one, sizeof(one)) < 0 && (errno == EINTR)) {}
+        }
+};
+
+#endif // __QUEUE_EVENT_FD__
@@ -0,0 +1,147 @@
+/**
+ * @file QueueInlet.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief close/reopen state of the inlet of a lock-free queue
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __QUEUE_INLET__
+#define __QUEUE_INLET__
+
+#include <atomic>
+#include <cstddef>
+#include "EventCount.hpp"
+
+/**
+ * @brief Decrement `counter` if it is positive, e.g. to reserve a free slot or an available element of a queue.
+ *
+ * @retval true `counter` was decremented.
+ * @retval false `counter` was 0.
+ */
+inline bool tryReserve(std::atomic<size_t> &counter) {
+    size_t n = counter.load(std::memory_order_relaxed);
+    while (n > 0) {
+        if (counter.compare_exchange_weak(n, n-1, std::memory_order_seq_cst)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief inlet of a queue whose `push` and `pop` do not share a lock, with the `closeInlet`/`reopenInlet` contract of `MultiThreadQueue`
+ * @details A pusher which has seen the inlet open may still be putting its element when the inlet is closed, so a consumer must not give up on the empty queue until no pusher is in flight (`isDrained`).
+ * The pushers register themselves and the consumers check the closure with sequentially-consistent operations: either a pusher sees the closure, or the consumer sees the pusher.
+ */
+class QueueInlet {
+    private:
+        std::atomic<bool> m_isClosed{false};
+        std::atomic<size_t> m_generation{0}; // the number of the reopenings
+        std::atomic<unsigned int> m_numPushersInFlight{0}; // the number of the pushers which may still put an element into the queue
+
+        /**
+         * @brief body of `push` and `tryPush`, waiting on `ec_notFull` unless it is `nullptr`
+         */
+        template <typename T_tryReserve, typename T_put>
+        bool pushImpl(EventCount *ec_notFull, EventCount &ec_notEmpty, T_tryReserve &tryReserve, T_put &put) {
+            m_numPushersInFlight.fetch_add(1, std::memory_order_seq_cst);
+            bool isReserved = false;
+            if (!m_isClosed.load(std::memory_order_seq_cst)) {
+                isReserved = tryReserve();
+                if (!isReserved && (ec_notFull != nullptr)) {
+                    ec_notFull->wait([&]{
+                        if (m_isClosed.load(std::memory_order_seq_cst)) {
+                            return true;
+                        }
+                        isReserved = tryReserve();
+                        return isReserved;
+                    });
+                }
+            }
+            if (isReserved) {
+                put();
+            }
+            /* Consumers waiting on the closed queue have to re-check once the last pusher leaves. */
+            if ((m_numPushersInFlight.fetch_sub(1, std::memory_order_seq_cst) == 1) && m_isClosed.load(std::memory_order_seq_cst)) {
+                ec_notEmpty.notifyAll();
+            }
+            return isReserved;
+        }
+
+    public:
+        /**
+         * @brief Check if the inlet is closed
+         */
+        bool isClosed() const {
+            return m_isClosed.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Get the generation of the queue, which is incremented by every `reopen`
+         *
+         * @return the generation, 0 until the queue is reopened for the first time
+         */
+        size_t generation() const {
+            return m_generation.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Check if the inlet is closed and no more element can arrive. A consumer finding the queue empty after this returns `true` may give up.
+         */
+        bool isDrained() const {
+            return m_isClosed.load(std::memory_order_seq_cst) && (m_numPushersInFlight.load(std::memory_order_seq_cst) == 0);
+        }
+
+        /**
+         * @brief Reserve room with `tryReserve` unless the inlet is closed, waiting on `ec_notFull` while the queue is full, then call `put`.
+         *
+         * @tparam T_tryReserve callable type which takes no argument and returns `bool`, must not block
+         * @tparam T_put callable type which takes no argument
+         * @param[in] ec_notFull the event count notified when room is freed or the inlet is closed
+         * @param[in] ec_notEmpty the event count the consumers wait on, notified when the last pusher leaves the closed inlet
+         * @param[in] tryReserve reserves room for (or puts) the element; called under the mutex of `ec_notFull` while waiting
+         * @param[in] put puts the element after a successful reservation and wakes a consumer, if `tryReserve` did not
+         * @retval true The element was reserved and put.
+         * @retval false The inlet was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        template <typename T_tryReserve, typename T_put>
+        bool push(EventCount &ec_notFull, EventCount &ec_notEmpty, T_tryReserve tryReserve, T_put put) {
+            return pushImpl(&ec_notFull, ec_notEmpty, tryReserve, put);
+        }
+
+        /**
+         * @brief As `push`, but fails instead of waiting while the queue is full.
+         *
+         * @retval true The element was reserved and put.
+         * @retval false The inlet was closed or the queue was full.
+         */
+        template <typename T_tryReserve, typename T_put>
+        bool tryPush(EventCount &ec_notEmpty, T_tryReserve tryReserve, T_put put) {
+            return pushImpl(nullptr, ec_notEmpty, tryReserve, put);
+        }
+
+        /**
+         * @brief Close the inlet. The queue wakes its waiters afterwards.
+         */
+        void close() {
+            m_isClosed.store(true, std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief Reopen the closed inlet and start a new generation. Does nothing if the inlet is open.
+         * @details A thread blocked in `pop` which has not observed the closure yet keeps waiting in the new generation,
+         * so consumers which rely on the closure to stop must have returned from `pop` before this method is called.
+         */
+        void reopen() {
+            bool isClosed = true;
+            if (m_isClosed.compare_exchange_strong(isClosed, false, std::memory_order_seq_cst)) {
+                m_generation.fetch_add(1, std::memory_order_release);
+            }
+        }
+};
+
+#endif // __QUEUE_INLET__
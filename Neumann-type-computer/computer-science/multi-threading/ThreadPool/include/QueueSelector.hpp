@@ -0,0 +1,189 @@
+/**
+ * @file QueueSelector.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief wait on any of several `MultiThreadQueue`s with one thread
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __QUEUE_SELECTOR__
+#define __QUEUE_SELECTOR__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "MultiThreadQueue.hpp"
+
+/**
+ * @brief blocks one thread until any of the registered queues is ready to pop (not-empty, or closed)
+ * @details The queues may hold different element types. Typical use:
+ * @code
+ * QueueSelector selector;
+ * const size_t i_results = selector.add(resultQueue);
+ * const size_t i_control = selector.add(controlQueue);
+ * for (;;) {
+ *     const size_t i = selector.waitAny();
+ *     if (i == i_results) {... resultQueue.tryPop(result) ...}
+ *     else {... controlQueue.tryPop(message) ...}
+ * }
+ * @endcode
+ * `waitAny` only reports readiness; pop the reported queue with `tryPop`, since another consumer may have taken the element in the meantime.
+ * A closed and drained queue stays ready forever, so `remove` it once `tryPop` returns `QueueOpStatus::CLOSED`.
+ * To be fair, every call scans the queues starting next to the one reported last, so a busy queue cannot starve the others.
+ * The registered queues must outlive their registration (the selector itself, or `remove`).
+ */
+class QueueSelector : public QueueReadinessObserver {
+    private:
+        struct Entry {
+            std::function<bool()> isReady;
+            std::function<void(QueueReadinessObserver *)> unregister;
+        };
+
+        std::vector<Entry> m_entries; // indexed by the value returned by `add`, an entry whose `isReady` is empty was removed
+        std::atomic<size_t> m_nextIndex{0}; // the index from which the next scan starts
+        std::mutex m_mtx;
+        std::condition_variable m_cv_ready;
+        uint64_t m_readySeq = 0; // incremented every time a queue becomes ready, guarded by `m_mtx`
+
+        /**
+         * @brief Scan the queues once, round-robin.
+         *
+         * @param[out] index the index of the ready queue
+         * @retval true A ready queue was found.
+         * @retval false No queue was ready.
+         */
+        bool poll(size_t &index) {
+            const size_t numEntries = m_entries.size();
+            const size_t start = m_nextIndex.load(std::memory_order_relaxed);
+            for (size_t k=0; k<numEntries; ++k) {
+                const size_t i = (start + k) % numEntries;
+                if (m_entries[i].isReady && m_entries[i].isReady()) {
+                    m_nextIndex.store(i+1, std::memory_order_relaxed);
+                    index = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        uint64_t readySeq() {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            return m_readySeq;
+        }
+
+    public:
+        QueueSelector() = default;
+        QueueSelector(const QueueSelector &) = delete;
+        QueueSelector &operator=(const QueueSelector &) = delete;
+
+        /**
+         * @brief Destroy the QueueSelector object and unregister it from the queues.
+         */
+        ~QueueSelector() {
+            for (Entry &entry : m_entries) {
+                if (entry.unregister) {entry.unregister(this);}
+            }
+        }
+
+        /**
+         * @brief Register a queue. Must not be called concurrently with the other methods.
+         *
+         * @param[in] queue the queue, which must outlive the registration
+         * @return the index which `waitAny` reports when the queue is ready
+         */
+        template <typename T_elem, typename T_storagePolicy, typename T_stats>
+        size_t add(MultiThreadQueue<T_elem, T_storagePolicy, T_stats> &queue) {
+            m_entries.push_back(Entry{
+                [&queue]{return queue.isReadyToPop();},
+                [&queue](QueueReadinessObserver *observer){queue.removeReadinessObserver(observer);}
+            });
+            queue.addReadinessObserver(this);
+            return m_entries.size()-1;
+        }
+
+        /**
+         * @brief Unregister a queue. The indices of the other queues do not change. Must not be called concurrently with the other methods.
+         *
+         * @param[in] index the index returned by `add`
+         */
+        void remove(size_t index) {
+            Entry &entry = m_entries.at(index);
+            if (entry.unregister) {
+                entry.unregister(this);
+            }
+            entry = Entry{};
+        }
+
+        /**
+         * @brief Block the caller until any registered queue is ready to pop.
+         *
+         * @return the index of the ready queue
+         */
+        size_t waitAny() {
+            for (;;) {
+                const uint64_t seq = readySeq();
+                size_t index;
+                if (poll(index)) {
+                    return index;
+                }
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_cv_ready.wait(lock, [this, seq]{return m_readySeq != seq;});
+            }
+        }
+
+        /**
+         * @brief Block the caller until any registered queue is ready to pop, or `deadline` passes.
+         *
+         * @tparam T_clock the clock of the deadline
+         * @tparam T_duration the duration type of the deadline
+         * @param[out] index the index of the ready queue
+         * @param[in] deadline the time point to give up
+         * @retval QueueOpStatus::SUCCESS A queue is ready and its index is stored to `index`.
+         * @retval QueueOpStatus::TIMEOUT No queue became ready by `deadline`.
+         */
+        template <typename T_clock, typename T_duration>
+        QueueOpStatus waitAnyUntil(size_t &index, const std::chrono::time_point<T_clock, T_duration> &deadline) {
+            for (;;) {
+                const uint64_t seq = readySeq();
+                if (poll(index)) {
+                    return QueueOpStatus::SUCCESS;
+                }
+                std::unique_lock<std::mutex> lock(m_mtx);
+                if (!m_cv_ready.wait_until(lock, deadline, [this, seq]{return m_readySeq != seq;})) {
+                    return QueueOpStatus::TIMEOUT;
+                }
+            }
+        }
+
+        /**
+         * @brief Block the caller until any registered queue is ready to pop, or `timeout` elapses.
+         *
+         * @param[out] index the index of the ready queue
+         * @param[in] timeout the max time to wait
+         * @return the same as `waitAnyUntil`
+         */
+        template <typename T_rep, typename T_period>
+        QueueOpStatus waitAnyFor(size_t &index, const std::chrono::duration<T_rep, T_period> &timeout) {
+            return waitAnyUntil(index, std::chrono::steady_clock::now() + timeout);
+        }
+
+        /**
+         * @brief Called by the queues when they become ready.
+         */
+        void onReady() override {
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                ++m_readySeq;
+            }
+            m_cv_ready.notify_all();
+        }
+};
+
+#endif // __QUEUE_SELECTOR__
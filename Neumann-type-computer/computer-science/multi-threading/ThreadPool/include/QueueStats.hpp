@@ -0,0 +1,177 @@
+/**
+ * @file QueueStats.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief occupancy and wait-time instrumentation for `MultiThreadQueue`
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __QUEUE_STATS__
+#define __QUEUE_STATS__
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief statistics of the threads blocked on one side (producers or consumers) of a queue
+ */
+struct QueueBlockedTimeStats {
+    uint64_t numBlocks = 0; // the number of the callings which had to wait
+    double total_s = 0; // the total blocked time in seconds
+    double p99_s = 0; // the 99th percentile of the blocked time in seconds, rounded up to a power of two nanoseconds
+};
+
+/**
+ * @brief point-in-time copy of the statistics of a queue
+ */
+struct QueueStatsSnapshot {
+    static constexpr size_t NUM_OCCUPANCY_BUCKETS = 10;
+
+    size_t depth = 0; // the current number of the elements
+    size_t peakDepth = 0; // the max number of the elements observed so far
+    std::array<uint64_t, NUM_OCCUPANCY_BUCKETS> occupancyHistogram{}; // the number of the depth changes which landed in each tenth of [0, capacity]
+    QueueBlockedTimeStats producers;
+    QueueBlockedTimeStats consumers;
+    uint64_t numNotifyOne = 0; // the number of `notify_one` callings on either condition variable
+    uint64_t numNotifyAll = 0; // the number of `notify_all` callings on either condition variable
+};
+
+/**
+ * @brief statistics collector which compiles to nothing; the default of `MultiThreadQueue`
+ */
+class NullQueueStats {
+    public:
+        struct BlockStart {};
+
+        explicit NullQueueStats(size_t capacity) {(void)capacity;}
+
+        void recordDepth(size_t depth) {(void)depth;}
+        BlockStart startBlock() const {return {};}
+        void recordProducerBlock(BlockStart start) {(void)start;}
+        void recordConsumerBlock(BlockStart start) {(void)start;}
+        void recordNotifyOne() {}
+        void recordNotifyAll() {}
+
+        /**
+         * @brief Get the statistics, which are always zero
+         */
+        QueueStatsSnapshot snapshot() const {return {};}
+};
+
+/**
+ * @brief statistics collector for `MultiThreadQueue`
+ * @details Select it with `MultiThreadQueue<T_elem, T_storagePolicy, QueueStats>`.
+ * The queue calls the `record*` methods with its lock held, so they are plain relaxed atomic updates without contention, and `snapshot` can be called from any thread without taking the lock.
+ * Blocked times are kept in a histogram of power-of-two nanosecond buckets, so the clock is read only by the callings which actually wait.
+ */
+class QueueStats {
+    private:
+        static constexpr size_t NUM_TIME_BUCKETS = 40; // 1 ns to 2^40 ns (about 18 minutes)
+
+        struct BlockedTime {
+            std::atomic<uint64_t> total_ns{0};
+            std::array<std::atomic<uint64_t>, NUM_TIME_BUCKETS> histogram{};
+
+            void record(std::chrono::steady_clock::time_point start) {
+                const uint64_t elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+                total_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+                size_t bucket = 0; // the bucket `b` holds [2^b, 2^(b+1)) ns
+                while ((bucket+1 < NUM_TIME_BUCKETS) && (elapsed_ns >> (bucket+1)) != 0) {++bucket;}
+                histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            QueueBlockedTimeStats snapshot() const {
+                QueueBlockedTimeStats stats;
+                std::array<uint64_t, NUM_TIME_BUCKETS> counts;
+                for (size_t b=0; b<NUM_TIME_BUCKETS; ++b) {
+                    counts[b] = histogram[b].load(std::memory_order_relaxed);
+                    stats.numBlocks += counts[b];
+                }
+                stats.total_s = total_ns.load(std::memory_order_relaxed)*1e-9;
+                const uint64_t rank = stats.numBlocks - stats.numBlocks/100; // the number of the samples at or below p99
+                uint64_t cumulative = 0;
+                for (size_t b=0; (b<NUM_TIME_BUCKETS) && (stats.numBlocks > 0); ++b) {
+                    cumulative += counts[b];
+                    if (cumulative >= rank) {
+                        stats.p99_s = static_cast<double>(uint64_t{1} << (b+1))*1e-9;
+                        break;
+                    }
+                }
+                return stats;
+            }
+        };
+
+        const size_t m_capacity;
+        std::atomic<size_t> m_depth{0};
+        std::atomic<size_t> m_peakDepth{0};
+        std::array<std::atomic<uint64_t>, QueueStatsSnapshot::NUM_OCCUPANCY_BUCKETS> m_occupancyHistogram{};
+        BlockedTime m_producers;
+        BlockedTime m_consumers;
+        std::atomic<uint64_t> m_numNotifyOne{0};
+        std::atomic<uint64_t> m_numNotifyAll{0};
+
+    public:
+        using BlockStart = std::chrono::steady_clock::time_point;
+
+        /**
+         * @brief Construct a new QueueStats object
+         *
+         * @param[in] capacity the capacity of the queue, used to scale the occupancy histogram
+         */
+        explicit QueueStats(size_t capacity) : m_capacity(capacity) {}
+
+        /**
+         * @brief Record a change of the queue depth.
+         */
+        void recordDepth(size_t depth) {
+            m_depth.store(depth, std::memory_order_relaxed);
+            if (depth > m_peakDepth.load(std::memory_order_relaxed)) {
+                m_peakDepth.store(depth, std::memory_order_relaxed);
+            }
+            const size_t bucket = std::min(depth, m_capacity)*QueueStatsSnapshot::NUM_OCCUPANCY_BUCKETS/(m_capacity+1);
+            m_occupancyHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the time point at which a calling starts to wait.
+         */
+        BlockStart startBlock() const {return std::chrono::steady_clock::now();}
+
+        /**
+         * @brief Record the end of the wait of a producer which started at `start`.
+         */
+        void recordProducerBlock(BlockStart start) {m_producers.record(start);}
+
+        /**
+         * @brief Record the end of the wait of a consumer which started at `start`.
+         */
+        void recordConsumerBlock(BlockStart start) {m_consumers.record(start);}
+
+        void recordNotifyOne() {m_numNotifyOne.fetch_add(1, std::memory_order_relaxed);}
+        void recordNotifyAll() {m_numNotifyAll.fetch_add(1, std::memory_order_relaxed);}
+
+        /**
+         * @brief Get a copy of the statistics. The fields are read one by one, so they may be slightly inconsistent with each other while the queue is in use.
+         */
+        QueueStatsSnapshot snapshot() const {
+            QueueStatsSnapshot stats;
+            stats.depth = m_depth.load(std::memory_order_relaxed);
+            stats.peakDepth = m_peakDepth.load(std::memory_order_relaxed);
+            for (size_t i=0; i<QueueStatsSnapshot::NUM_OCCUPANCY_BUCKETS; ++i) {
+                stats.occupancyHistogram[i] = m_occupancyHistogram[i].load(std::memory_order_relaxed);
+            }
+            stats.producers = m_producers.snapshot();
+            stats.consumers = m_consumers.snapshot();
+            stats.numNotifyOne = m_numNotifyOne.load(std::memory_order_relaxed);
+            stats.numNotifyAll = m_numNotifyAll.load(std::memory_order_relaxed);
+            return stats;
+        }
+};
+
+#endif // __QUEUE_STATS__
@@ -0,0 +1,241 @@
+/**
+ * @file QueueStorage.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief element storages for `MultiThreadQueue`
+ * @version 0.3.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __QUEUE_STORAGE__
+#define __QUEUE_STORAGE__
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <new>
+#include <queue>
+#include <utility>
+#include "ConcurrencyUtil.hpp"
+
+/**
+ * @brief `std::queue` (backed by `std::deque`) based storage.
+ * @details The deque allocates and frees blocks as it grows and shrinks.
+ *
+ * @tparam T_elem the data type of elements
+ */
+template <typename T_elem>
+class DequeStorage : public std::queue<T_elem> {
+    public:
+        /**
+         * @brief Construct a new DequeStorage object
+         *
+         * @param[in] capacity unused, the deque grows on demand
+         */
+        explicit DequeStorage(size_t capacity) {(void)capacity;}
+
+        /**
+         * @brief Get the number of the slots in use, which is the number of the elements
+         */
+        size_t occupied() const {return this->size();}
+
+        /**
+         * @brief Get the number of the slots which are freed later than their elements leave the queue, which is always 0
+         */
+        size_t numBorrowed() const {return 0;}
+
+        /**
+         * @brief Exchange all the elements with `elems` in constant time, without moving or destroying any element.
+         *
+         * @param[in,out] elems the elements to be put into the storage, which receives the elements previously held
+         */
+        void swapElements(std::deque<T_elem> &elems) {std::swap(this->c, elems);}
+};
+
+/**
+ * @brief ring buffer storage which allocates exactly `capacity` slots at construction time
+ * @details All the slots live in one array aligned to a cache line. Elements are constructed in place by `emplace` and destroyed by `pop`, so that no heap allocation happens after construction.
+ * The caller must not occupy more than `capacity` slots; `MultiThreadQueue` guarantees this.
+ *
+ * Besides `emplace`/`pop`, a slot can be reserved and published in two steps (`claim`/`commit`) and read in place before being freed (`borrow`/`release`).
+ * The ring is divided into consecutive regions: borrowed slots, visible elements, claimed slots and free slots.
+ * Commits and releases may come out of order; a slot moves to the next region only when all the slots before it did.
+ *
+ * @tparam T_elem the data type of elements
+ */
+template <typename T_elem>
+class RingStorage {
+    private:
+        static constexpr std::align_val_t ALIGNMENT{std::max(alignof(T_elem), CACHE_LINE_SIZE)};
+
+        const size_t m_capacity;
+        T_elem *m_slots;
+        const std::unique_ptr<bool[]> m_isDone; // per slot, `true` if committed (claimed region) or released (borrowed region) ahead of its predecessors
+        size_t m_head = 0; // index of the front visible element
+        size_t m_size = 0; // the number of the visible elements
+        size_t m_numBorrowed = 0; // the number of the borrowed slots, which precede `m_head`
+        size_t m_numClaimed = 0; // the number of the claimed slots, which follow the visible elements
+
+        size_t wrap(size_t i) const {return (i >= m_capacity) ? i-m_capacity : i;}
+        size_t firstBorrowedIndex() const {return wrap(m_head + m_capacity - m_numBorrowed);}
+        size_t firstClaimedIndex() const {return wrap(m_head + m_size);}
+        size_t indexOf(const T_elem *slot) const {return static_cast<size_t>(slot - m_slots);}
+
+    public:
+        /**
+         * @brief Construct a new RingStorage object
+         *
+         * @param[in] capacity the number of the slots, must be 1 or greater
+         */
+        explicit RingStorage(size_t capacity) : m_capacity(capacity), m_slots(static_cast<T_elem *>(::operator new(capacity*sizeof(T_elem), ALIGNMENT))), m_isDone(new bool[capacity]()) {
+            assert(capacity > 0);
+        }
+
+        RingStorage(const RingStorage &) = delete;
+        RingStorage &operator=(const RingStorage &) = delete;
+
+        /**
+         * @brief Destroy the remaining elements and free the slots
+         */
+        ~RingStorage() {
+            for (size_t i=0; i<m_numBorrowed; ++i) {
+                const size_t idx = wrap(firstBorrowedIndex() + i);
+                if (!m_isDone[idx]) {m_slots[idx].~T_elem();}
+            }
+            for (size_t i=0; i<m_size+m_numClaimed; ++i) {
+                m_slots[wrap(m_head + i)].~T_elem();
+            }
+            ::operator delete(m_slots, ALIGNMENT);
+        }
+
+        /**
+         * @brief Get the number of the visible elements
+         */
+        size_t size() const {return m_size;}
+
+        /**
+         * @brief Get the number of the slots in use, including the borrowed and the claimed ones
+         */
+        size_t occupied() const {return m_numBorrowed + m_size + m_numClaimed;}
+
+        /**
+         * @brief Get the number of the borrowed slots, which are not freed until they are released
+         */
+        size_t numBorrowed() const {return m_numBorrowed;}
+
+        bool empty() const {return m_size == 0;}
+        T_elem &front() {return m_slots[m_head];}
+
+        /**
+         * @brief Construct an element in place at the end.
+         * @details If there are claimed slots, the element becomes visible when they are committed.
+         *
+         * @tparam T_args the types of the constructor arguments
+         * @param[in] args the arguments forwarded to the constructor of `T_elem`
+         */
+        template <typename... T_args>
+        void emplace(T_args&&... args) {
+            commit(claim(std::forward<T_args>(args)...));
+        }
+
+        /**
+         * @brief Destroy the front element.
+         */
+        void pop() {
+            release(borrow());
+        }
+
+        /**
+         * @brief Reserve the next free slot and construct an element in it.
+         * @details Without arguments the element is default-initialized, so a trivial payload (e.g. `std::array<float, N>`) is not even zero-filled.
+         *
+         * @tparam T_args the types of the constructor arguments
+         * @param[in] args the arguments forwarded to the constructor of `T_elem`
+         * @return pointer to the element in the slot, which stays invisible until `commit` is called
+         */
+        template <typename... T_args>
+        T_elem *claim(T_args&&... args) {
+            assert(occupied() < m_capacity);
+            const size_t idx = wrap(firstClaimedIndex() + m_numClaimed);
+            if constexpr (sizeof...(T_args) == 0) {
+                new (&m_slots[idx]) T_elem;
+            } else {
+                new (&m_slots[idx]) T_elem(std::forward<T_args>(args)...);
+            }
+            m_isDone[idx] = false;
+            ++m_numClaimed;
+            return &m_slots[idx];
+        }
+
+        /**
+         * @brief Publish a claimed slot.
+         *
+         * @param[in] slot the pointer returned by `claim`
+         * @return the number of the elements which became visible by this call
+         */
+        size_t commit(T_elem *slot) {
+            m_isDone[indexOf(slot)] = true;
+            size_t numPublished = 0;
+            while ((m_numClaimed > 0) && m_isDone[firstClaimedIndex()]) {
+                m_isDone[firstClaimedIndex()] = false;
+                ++m_size;
+                --m_numClaimed;
+                ++numPublished;
+            }
+            return numPublished;
+        }
+
+        /**
+         * @brief Take the front element out of the visible region without freeing its slot.
+         *
+         * @return pointer to the element, which stays valid until `release` is called
+         */
+        T_elem *borrow() {
+            assert(m_size > 0);
+            const size_t idx = m_head;
+            m_head = wrap(m_head + 1);
+            --m_size;
+            ++m_numBorrowed;
+            m_isDone[idx] = false;
+            return &m_slots[idx];
+        }
+
+        /**
+         * @brief Destroy a borrowed element and free its slot.
+         *
+         * @param[in] slot the pointer returned by `borrow`
+         * @return the number of the slots which became free by this call
+         */
+        size_t release(T_elem *slot) {
+            slot->~T_elem();
+            m_isDone[indexOf(slot)] = true;
+            size_t numFreed = 0;
+            while ((m_numBorrowed > 0) && m_isDone[firstBorrowedIndex()]) {
+                m_isDone[firstBorrowedIndex()] = false;
+                --m_numBorrowed;
+                ++numFreed;
+            }
+            return numFreed;
+        }
+};
+
+/**
+ * @brief storage policy which selects `DequeStorage`
+ */
+struct DequeStoragePolicy {
+    template <typename T_elem>
+    using Storage = DequeStorage<T_elem>;
+};
+
+/**
+ * @brief storage policy which selects `RingStorage`
+ */
+struct RingStoragePolicy {
+    template <typename T_elem>
+    using Storage = RingStorage<T_elem>;
+};
+
+#endif // __QUEUE_STORAGE__
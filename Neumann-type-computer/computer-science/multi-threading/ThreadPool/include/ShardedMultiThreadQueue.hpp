@@ -0,0 +1,281 @@
+/**
+ * @file ShardedMultiThreadQueue.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief bounded MPMC queue striped over several locked sub-queues
+ * @version 0.4.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __SHARDED_MULTI_THREAD_QUEUE__
+#define __SHARDED_MULTI_THREAD_QUEUE__
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "ConcurrencyUtil.hpp"
+#include "EventCount.hpp"
+#include "QueueInlet.hpp"
+
+/**
+ * @brief bounded multi-producer multi-consumer queue whose elements are spread over several sub-queues ("shards"), each with its own lock
+ * @details Drop-in replacement of `MultiThreadQueue` for many producers, where a single lock serializes everything.
+ * Each thread has a home shard: `push` appends to it, and `pop` takes from it first, then steals from the other shards.
+ * The global capacity and the emptiness are tracked by two atomic counters, so blocking and `closeInlet` behave as `MultiThreadQueue`.
+ * The order is relaxed: elements pushed by one thread are popped in FIFO order, but there is no global FIFO order among threads.
+ * Threads block (in `EventCount`) only when the queue is full or empty.
+ *
+ * @tparam T_elem the data type of elements
+ */
+template <typename T_elem>
+class ShardedMultiThreadQueue {
+    private:
+
+        struct alignas(CACHE_LINE_SIZE) Shard {
+            std::mutex mtx;
+            std::deque<T_elem> queue; // guarded by `mtx`
+        };
+
+        const size_t m_capacity;
+        const size_t m_numShards;
+        const std::unique_ptr<Shard[]> m_shards;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_numFreeSlots; // slots not reserved by any pusher
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_numAvailable{0}; // elements inserted and not reserved by any popper
+        alignas(CACHE_LINE_SIZE) QueueInlet m_inlet;
+        EventCount m_ec_notFull;
+        EventCount m_ec_notEmpty;
+
+        /**
+         * @brief Get the home shard index of the caller thread. Threads are numbered in the order of their first call, so consecutive threads get different shards.
+         */
+        size_t homeShard() const {
+            static std::atomic<size_t> s_numThreads{0};
+            thread_local const size_t threadIndex = s_numThreads.fetch_add(1, std::memory_order_relaxed);
+            return threadIndex % m_numShards;
+        }
+
+        /**
+         * @brief Take an element whose existence has been reserved from `m_numAvailable`, from the home shard first.
+         *
+         * @param[out] elem pointer to the data which the popped data to be stored, or `nullptr` to discard the popped data
+         */
+        void takeReserved(T_elem *elem) {
+            for (size_t start = homeShard();; ++start) { // An element is guaranteed to be found since it was reserved.
+                for (size_t k=0; k<m_numShards; ++k) {
+                    Shard &shard = m_shards[(start + k) % m_numShards];
+                    std::lock_guard<std::mutex> lock(shard.mtx);
+                    if (!shard.queue.empty()) {
+                        if (elem != nullptr) {
+                            *elem = std::move(shard.queue.front());
+                        }
+                        shard.queue.pop_front();
+                        return;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Put an element, whose slot has been reserved from `m_numFreeSlots`, into the home shard of the caller thread and wake a consumer.
+         */
+        void putReserved(T_elem elem) {
+            Shard &shard = m_shards[homeShard()];
+            {
+                std::lock_guard<std::mutex> lock(shard.mtx);
+                shard.queue.push_back(std::move(elem));
+            }
+            m_numAvailable.fetch_add(1, std::memory_order_seq_cst);
+            m_ec_notEmpty.notifyOne();
+        }
+
+    public:
+        /**
+         * @brief Construct a new ShardedMultiThreadQueue object
+         *
+         * @param[in] capacity The max number of the elements which can be held in the queue (over all the shards), must be 1 or greater.
+         * @param[in] numShards the number of the shards, or 0 to use the number of the hardware threads
+         */
+        ShardedMultiThreadQueue(size_t capacity, size_t numShards = 0) :
+            m_capacity(capacity),
+            m_numShards((numShards > 0) ? numShards : std::max(1u, std::thread::hardware_concurrency())),
+            m_shards(new Shard[m_numShards]),
+            m_numFreeSlots(capacity)
+        {
+            assert(capacity > 0);
+        }
+
+        ShardedMultiThreadQueue(const ShardedMultiThreadQueue &) = delete;
+        ShardedMultiThreadQueue &operator=(const ShardedMultiThreadQueue &) = delete;
+
+        /**
+         * @brief Get the capacity of the queue
+         *
+         * @return capacity
+         */
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        /**
+         * @brief Get the number of the shards
+         *
+         * @return the number of the shards
+         */
+        size_t numShards() const {
+            return m_numShards;
+        }
+
+        /**
+         * @brief Check if the inlet is closed
+         *
+         * @retval true the inlet is closed
+         * @retval false the inlet is open
+         */
+        bool isInletClosed() const {
+            return m_inlet.isClosed();
+        }
+
+        /**
+         * @brief Get the generation of the queue, which is incremented by every `reopenInlet`
+         *
+         * @return the generation, 0 until the queue is reopened for the first time
+         */
+        size_t generation() const {
+            return m_inlet.generation();
+        }
+
+        /**
+         * @brief Push an element to the home shard of the caller thread. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         *
+         * @param[in] elem the data to be pushed into the queue
+         * @retval true The data was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        bool push(T_elem elem) {
+            return m_inlet.push(m_ec_notFull, m_ec_notEmpty, [this]{return tryReserve(m_numFreeSlots);}, [&]{putReserved(std::move(elem));});
+        }
+
+        /**
+         * @brief Push an element to the queue without blocking.
+         *
+         * @param[in,out] elem the data to be moved into the queue, which is left untouched on failure
+         * @retval true The data was pushed into the queue.
+         * @retval false The queue was closed or full.
+         */
+        bool tryPush(T_elem &elem) {
+            return m_inlet.tryPush(m_ec_notEmpty, [this]{return tryReserve(m_numFreeSlots);}, [&]{putReserved(std::move(elem));});
+        }
+
+        /**
+         * @brief Pop an element, from the home shard of the caller thread if possible. If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @retval true The data was successfully popped from the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-empty.
+         */
+        bool pop(T_elem &elem) {
+            bool isReserved = tryReserve(m_numAvailable);
+            if (!isReserved) {
+                m_ec_notEmpty.wait([&]{
+                    isReserved = tryReserve(m_numAvailable);
+                    if (isReserved) {
+                        return true;
+                    }
+                    if (m_inlet.isDrained()) {
+                        isReserved = tryReserve(m_numAvailable);
+                        return true;
+                    }
+                    return false;
+                });
+            }
+            if (!isReserved) {
+                return false;
+            }
+            takeReserved(&elem);
+            m_numFreeSlots.fetch_add(1, std::memory_order_seq_cst);
+            m_ec_notFull.notifyOne();
+            return true;
+        }
+
+        /**
+         * @brief Pop an element from the queue without blocking.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @retval true The data was popped from the queue.
+         * @retval false The queue was empty.
+         */
+        bool tryPop(T_elem &elem) {
+            if (!tryReserve(m_numAvailable)) {
+                return false;
+            }
+            takeReserved(&elem);
+            m_numFreeSlots.fetch_add(1, std::memory_order_seq_cst);
+            m_ec_notFull.notifyOne();
+            return true;
+        }
+
+        /**
+         * @brief Take all the elements out of the queue and return them to the caller, in no particular order (FIFO per pushing thread).
+         * @details All the available elements are reserved at once, then taken shard by shard; each shard lock is held only to move one element out. `T_elem` must be default-constructible.
+         *
+         * @return the elements which were in the queue
+         */
+        std::deque<T_elem> drain() {
+            const size_t numReserved = m_numAvailable.exchange(0, std::memory_order_seq_cst);
+            std::deque<T_elem> drained(numReserved);
+            for (T_elem &elem : drained) {
+                takeReserved(&elem);
+            }
+            if (numReserved > 0) {
+                m_numFreeSlots.fetch_add(numReserved, std::memory_order_seq_cst);
+                m_ec_notFull.notifyAll();
+            }
+            return drained;
+        }
+
+        /**
+         * @brief Pop all elements from the queue.
+         * @details One typically uses this method to abort pending tasks under producer-consumer thread model; calls `closeInlet` method, then calls `popAll` method.
+         * The elements are taken by `drain` and destroyed without any shard lock held.
+         */
+        void popAll() {
+            drain();
+        }
+
+        /**
+         * @brief Close the queue inlet.
+         * @details After the queue inlet is closed:
+         * @par 1. Following or currently-blocked `push` callings return with `false`.
+         * @par 2. Following or currently-blocked `pop` callings return with `true` as far as there is at least one element in the queue, otherwise return with `false`.
+         */
+        void closeInlet() {
+            m_inlet.close();
+            m_ec_notFull.notifyAll();
+            m_ec_notEmpty.notifyAll();
+        }
+
+        /**
+         * @brief Reopen the closed queue inlet and start a new generation, so that the queue can be used again.
+         * @details The elements left in the queue are kept. See `QueueInlet::reopen` for the consumers still blocked in `pop`.
+         */
+        void reopenInlet() {
+            m_inlet.reopen();
+        }
+};
+
+/**
+ * @brief queue policy to build containers (e.g. `BasicThreadPool`) on `ShardedMultiThreadQueue`
+ */
+struct ShardedQueuePolicy {
+    template <typename T_elem>
+    using Queue = ShardedMultiThreadQueue<T_elem>;
+};
+
+#endif // __SHARDED_MULTI_THREAD_QUEUE__
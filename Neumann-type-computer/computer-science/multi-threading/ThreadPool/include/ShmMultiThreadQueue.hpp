@@ -0,0 +1,319 @@
+/**
+ * @file ShmMultiThreadQueue.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief cross-process queue living in POSIX shared memory (Linux only)
+ * @version 0.1.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __SHM_MULTI_THREAD_QUEUE__
+#define __SHM_MULTI_THREAD_QUEUE__
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ConcurrencyUtil.hpp"
+
+/**
+ * @brief how `ShmMultiThreadQueue` opens the shared memory object
+ */
+enum class ShmOpenMode {
+    CREATE, // Create a new object; fails if the name already exists.
+    ATTACH // Attach to an object created by another `ShmMultiThreadQueue`; waits (up to a timeout) for the creator to finish initialization.
+};
+
+/**
+ * @brief thread-safe and process-safe queue in a named POSIX shared memory object
+ * @details Counterpart of `MultiThreadQueue` for producers and consumers in different processes.
+ * The elements are copied into and out of the shared ring directly, so a transfer costs neither a system call nor a kernel buffer copy unless a thread has to block.
+ * The lock and the condition variables are process-shared pthread primitives, and the lock is robust: if a process dies while holding it, the queue is closed so that the peers do not hang.
+ * `closeInlet` is seen by all the attached processes.
+ * The creator unlinks the name on destruction; the memory itself lives until the last process unmaps it.
+ * Open failures throw `std::system_error`.
+ *
+ * @tparam T_elem the data type of elements, which must be trivially copyable (no pointers into a process' own memory)
+ */
+template <typename T_elem>
+class ShmMultiThreadQueue {
+    static_assert(std::is_trivially_copyable_v<T_elem>, "ShmMultiThreadQueue requires a trivially copyable element type");
+
+    private:
+        static constexpr uint64_t MAGIC = 0x53484d5154303031; // "SHMQT001"
+        static constexpr std::chrono::seconds ATTACH_TIMEOUT{5};
+
+        struct Header {
+            std::atomic<uint32_t> isInitialized; // set by the creator after everything else is initialized
+            uint64_t magic;
+            size_t elemSize;
+            size_t capacity;
+            pthread_mutex_t mtx;
+            pthread_cond_t cv_notFull;
+            pthread_cond_t cv_notEmpty;
+            size_t head; // guarded by `mtx`
+            size_t size; // guarded by `mtx`
+            bool isInletClosed; // guarded by `mtx`
+        };
+
+        static constexpr size_t SLOTS_OFFSET = (sizeof(Header) + CACHE_LINE_SIZE-1)/CACHE_LINE_SIZE*CACHE_LINE_SIZE;
+
+        const std::string m_name;
+        const bool m_isCreator;
+        size_t m_mappedSize = 0;
+        void *m_mapped = nullptr;
+        Header *m_header = nullptr;
+        T_elem *m_slots = nullptr;
+
+        static size_t mappedSizeFor(size_t capacity) {return SLOTS_OFFSET + capacity*sizeof(T_elem);}
+
+        [[noreturn]] static void throwErrno(const char *what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        void map(int fd, size_t size) {
+            m_mappedSize = size;
+            m_mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (m_mapped == MAP_FAILED) {
+                const int err = errno;
+                m_mapped = nullptr;
+                close(fd);
+                throw std::system_error(err, std::generic_category(), "mmap");
+            }
+            close(fd);
+            m_header = static_cast<Header *>(m_mapped);
+            m_slots = reinterpret_cast<T_elem *>(static_cast<unsigned char *>(m_mapped) + SLOTS_OFFSET);
+        }
+
+        void create(size_t capacity) {
+            assert(capacity > 0);
+            const int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd < 0) {throwErrno("shm_open");}
+            if (ftruncate(fd, static_cast<off_t>(mappedSizeFor(capacity))) != 0) {
+                const int err = errno;
+                close(fd);
+                shm_unlink(m_name.c_str());
+                throw std::system_error(err, std::generic_category(), "ftruncate");
+            }
+            try {
+                map(fd, mappedSizeFor(capacity));
+            } catch (...) {
+                shm_unlink(m_name.c_str());
+                throw;
+            }
+
+            Header *const h = m_header;
+            h->magic = MAGIC;
+            h->elemSize = sizeof(T_elem);
+            h->capacity = capacity;
+            h->head = 0;
+            h->size = 0;
+            h->isInletClosed = false;
+            pthread_mutexattr_t mtxAttr;
+            pthread_mutexattr_init(&mtxAttr);
+            pthread_mutexattr_setpshared(&mtxAttr, PTHREAD_PROCESS_SHARED);
+            pthread_mutexattr_setrobust(&mtxAttr, PTHREAD_MUTEX_ROBUST);
+            pthread_mutex_init(&h->mtx, &mtxAttr);
+            pthread_mutexattr_destroy(&mtxAttr);
+            pthread_condattr_t cvAttr;
+            pthread_condattr_init(&cvAttr);
+            pthread_condattr_setpshared(&cvAttr, PTHREAD_PROCESS_SHARED);
+            pthread_cond_init(&h->cv_notFull, &cvAttr);
+            pthread_cond_init(&h->cv_notEmpty, &cvAttr);
+            pthread_condattr_destroy(&cvAttr);
+            h->isInitialized.store(1, std::memory_order_release);
+        }
+
+        void attach() {
+            const auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+            int fd;
+            struct stat st;
+            for (;;) {
+                fd = shm_open(m_name.c_str(), O_RDWR, 0600);
+                if ((fd >= 0) && (fstat(fd, &st) == 0) && (static_cast<size_t>(st.st_size) >= sizeof(Header))) {
+                    break;
+                }
+                if ((fd < 0) && (errno != ENOENT)) {throwErrno("shm_open");}
+                if (fd >= 0) {close(fd);}
+                if (std::chrono::steady_clock::now() > deadline) {
+                    throw std::system_error(ETIMEDOUT, std::generic_category(), "ShmMultiThreadQueue attach");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            map(fd, static_cast<size_t>(st.st_size));
+            while (m_header->isInitialized.load(std::memory_order_acquire) == 0) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    throw std::system_error(ETIMEDOUT, std::generic_category(), "ShmMultiThreadQueue attach");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if ((m_header->magic != MAGIC) || (m_header->elemSize != sizeof(T_elem)) || (mappedSizeFor(m_header->capacity) > m_mappedSize)) {
+                throw std::system_error(EINVAL, std::generic_category(), "ShmMultiThreadQueue attach: layout mismatch");
+            }
+        }
+
+        /**
+         * @brief Recover the lock after its previous owner died: close the queue and wake everyone up.
+         */
+        void recoverLocked() {
+            m_header->isInletClosed = true;
+            pthread_mutex_consistent(&m_header->mtx);
+            pthread_cond_broadcast(&m_header->cv_notFull);
+            pthread_cond_broadcast(&m_header->cv_notEmpty);
+        }
+
+        void lock() {
+            if (pthread_mutex_lock(&m_header->mtx) == EOWNERDEAD) {recoverLocked();}
+        }
+
+        void unlock() {
+            pthread_mutex_unlock(&m_header->mtx);
+        }
+
+        void wait(pthread_cond_t *cv) {
+            if (pthread_cond_wait(cv, &m_header->mtx) == EOWNERDEAD) {recoverLocked();}
+        }
+
+    public:
+        /**
+         * @brief Create or attach to a shared memory queue
+         *
+         * @param[in] name the name of the shared memory object, e.g. "/captureQueue"
+         * @param[in] mode whether to create a new object or attach to an existing one
+         * @param[in] capacity The max number of the elements which can be held in the queue, must be 1 or greater. Ignored when attaching.
+         */
+        ShmMultiThreadQueue(const std::string &name, ShmOpenMode mode, size_t capacity = 0) : m_name(name), m_isCreator(mode == ShmOpenMode::CREATE) {
+            try {
+                if (m_isCreator) {
+                    create(capacity);
+                } else {
+                    attach();
+                }
+            } catch (...) {
+                if (m_mapped != nullptr) {munmap(m_mapped, m_mappedSize);}
+                if (m_isCreator && (m_mapped != nullptr)) {shm_unlink(m_name.c_str());}
+                throw;
+            }
+        }
+
+        ShmMultiThreadQueue(const ShmMultiThreadQueue &) = delete;
+        ShmMultiThreadQueue &operator=(const ShmMultiThreadQueue &) = delete;
+
+        /**
+         * @brief Unmap the queue, and unlink its name if this object created it
+         */
+        ~ShmMultiThreadQueue() {
+            if (m_mapped != nullptr) {munmap(m_mapped, m_mappedSize);}
+            if (m_isCreator) {shm_unlink(m_name.c_str());}
+        }
+
+        /**
+         * @brief Get the capacity of the queue
+         *
+         * @return capacity
+         */
+        size_t capacity() const {
+            return m_header->capacity;
+        }
+
+        /**
+         * @brief Check if the inlet is closed
+         *
+         * @retval true the inlet is closed
+         * @retval false the inlet is open
+         */
+        bool isInletClosed() {
+            lock();
+            const bool isClosed = m_header->isInletClosed;
+            unlock();
+            return isClosed;
+        }
+
+        /**
+         * @brief Push a copy of an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed (by any process).
+         *
+         * @param[in] elem the data to be pushed into the queue
+         * @retval true The data was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        bool push(const T_elem &elem) {
+            Header *const h = m_header;
+            lock();
+            while ((h->size >= h->capacity) && !h->isInletClosed) {wait(&h->cv_notFull);}
+            if (h->isInletClosed) {
+                unlock();
+                return false;
+            }
+            const size_t tail = (h->head + h->size) % h->capacity;
+            std::memcpy(&m_slots[tail], &elem, sizeof(T_elem));
+            ++h->size;
+            pthread_cond_signal(&h->cv_notEmpty); // no system call unless a thread is waiting
+            unlock();
+            return true;
+        }
+
+        /**
+         * @brief Pop an element from the queue. If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed (by any process).
+         *
+         * @param[out] elem the reference to the data which the popped data to be copied into
+         * @retval true The data was successfully popped from the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-empty.
+         */
+        bool pop(T_elem &elem) {
+            Header *const h = m_header;
+            lock();
+            while ((h->size == 0) && !h->isInletClosed) {wait(&h->cv_notEmpty);}
+            if (h->size == 0) {
+                unlock();
+                return false;
+            }
+            std::memcpy(&elem, &m_slots[h->head], sizeof(T_elem));
+            h->head = (h->head + 1) % h->capacity;
+            --h->size;
+            pthread_cond_signal(&h->cv_notFull);
+            unlock();
+            return true;
+        }
+
+        /**
+         * @brief Pop all elements from the queue.
+         */
+        void popAll() {
+            Header *const h = m_header;
+            lock();
+            h->head = 0;
+            h->size = 0;
+            pthread_cond_broadcast(&h->cv_notFull);
+            unlock();
+        }
+
+        /**
+         * @brief Close the queue inlet, for all the attached processes.
+         * @details After the queue inlet is closed:
+         * @par 1. Following or currently-blocked `push` callings return with `false`.
+         * @par 2. Following or currently-blocked `pop` callings return with `true` as far as there is at least one element in the queue, otherwise return with `false`.
+         */
+        void closeInlet() {
+            Header *const h = m_header;
+            lock();
+            h->isInletClosed = true;
+            pthread_cond_broadcast(&h->cv_notFull);
+            pthread_cond_broadcast(&h->cv_notEmpty);
+            unlock();
+        }
+};
+
+#endif // __SHM_MULTI_THREAD_QUEUE__
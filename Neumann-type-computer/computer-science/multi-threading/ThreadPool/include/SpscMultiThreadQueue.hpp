@@ -0,0 +1,245 @@
+/**
+ * @file SpscMultiThreadQueue.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief wait-free single-producer single-consumer queue
+ * @version 0.2.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __SPSC_MULTI_THREAD_QUEUE__
+#define __SPSC_MULTI_THREAD_QUEUE__
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+#include "ConcurrencyUtil.hpp"
+#include "EventCount.hpp"
+
+/**
+ * @brief wait-free bounded single-producer single-consumer queue
+ * @details Replacement of `MultiThreadQueue` for pipeline stages which connect exactly one producer thread to one consumer thread.
+ * `push` must be called only from one thread, and `pop` and `popAll` must be called only from one (other) thread.
+ * `closeInlet` may be called from any thread, as `MultiThreadQueue::closeInlet`: a `push` racing it is either rejected or seen by the consumer.
+ * The closure is a flag bit of the tail index, so the producer publishes an element and checks the closure in one read-modify-write, without a separate handshake.
+ * The ring has a power-of-two number of slots so that indices are wrapped by masking, and each side caches the index of the other side to avoid touching its cache line on every operation.
+ * Threads block (in `EventCount`) only when the queue is full or empty.
+ *
+ * @tparam T_elem the data type of elements
+ */
+template <typename T_elem>
+class SpscMultiThreadQueue {
+    private:
+
+        struct Slot {
+            alignas(T_elem) unsigned char storage[sizeof(T_elem)];
+
+            T_elem *elemPtr() {return std::launder(reinterpret_cast<T_elem *>(storage));}
+        };
+
+        const size_t m_capacity;
+        const size_t m_mask;
+        const std::unique_ptr<Slot[]> m_slots;
+
+        static constexpr size_t CLOSED_BIT = ~(~size_t(0) >> 1); // the flag bit of `m_tail` set by `closeInlet`
+
+        enum class EnqueueResult {PUSHED, FULL, CLOSED};
+
+        /* producer side */
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0}; // the tail index, with `CLOSED_BIT` once the inlet is closed
+        size_t m_cachedHead = 0;
+
+        /* consumer side */
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};
+        size_t m_cachedTail = 0;
+
+        alignas(CACHE_LINE_SIZE) EventCount m_ec_notFull;
+        EventCount m_ec_notEmpty;
+
+        /**
+         * @brief Try to put an element into the queue without blocking. Called only by the producer.
+         *
+         * @param[in,out] elem the data to be moved into the queue, which is left untouched if the queue is full
+         * @return `PUSHED`, `FULL` or `CLOSED`
+         */
+        EnqueueResult tryEnqueue(T_elem &elem) {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if ((tail & CLOSED_BIT) != 0) {
+                return EnqueueResult::CLOSED;
+            }
+            if (tail - m_cachedHead >= m_capacity) {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead >= m_capacity) {
+                    return EnqueueResult::FULL;
+                }
+            }
+            T_elem *const ptr = new (m_slots[tail & m_mask].storage) T_elem(std::move(elem));
+            /* Only `closeInlet` changes the tail besides the producer, so the exchange fails only when the inlet has just been closed: then the consumer may already have given up on the queue. */
+            if (!m_tail.compare_exchange_strong(tail, tail+1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                ptr->~T_elem();
+                return EnqueueResult::CLOSED;
+            }
+            return EnqueueResult::PUSHED;
+        }
+
+        /**
+         * @brief Try to take an element from the queue without blocking. Called only by the consumer.
+         *
+         * @param[out] elem pointer to the data which the popped data to be stored, or `nullptr` to discard the popped data
+         * @retval true The data was popped.
+         * @retval false The queue was empty.
+         */
+        bool tryDequeue(T_elem *elem) {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_cachedTail) {
+                m_cachedTail = m_tail.load(std::memory_order_acquire) & ~CLOSED_BIT;
+                if (head == m_cachedTail) {
+                    return false;
+                }
+            }
+            T_elem *const ptr = m_slots[head & m_mask].elemPtr();
+            if (elem != nullptr) {
+                *elem = std::move(*ptr);
+            }
+            ptr->~T_elem();
+            m_head.store(head+1, std::memory_order_release);
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Construct a new SpscMultiThreadQueue object
+         *
+         * @param[in] capacity The max number of the elements which can be held in the queue, must be 1 or greater. The ring itself is rounded up to a power of two.
+         */
+        SpscMultiThreadQueue(size_t capacity) : m_capacity(capacity), m_mask(ceilPow2(capacity)-1), m_slots(new Slot[ceilPow2(capacity)]) {
+            assert(capacity > 0);
+        }
+
+        SpscMultiThreadQueue(const SpscMultiThreadQueue &) = delete;
+        SpscMultiThreadQueue &operator=(const SpscMultiThreadQueue &) = delete;
+
+        /**
+         * @brief Destroy the SpscMultiThreadQueue object and the remaining elements
+         */
+        ~SpscMultiThreadQueue() {
+            while (tryDequeue(nullptr)) {}
+        }
+
+        /**
+         * @brief Get the capacity of the queue
+         *
+         * @return capacity
+         */
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        /**
+         * @brief Check if the inlet is closed
+         *
+         * @retval true the inlet is closed
+         * @retval false the inlet is open
+         */
+        bool isInletClosed() const {
+            return (m_tail.load(std::memory_order_acquire) & CLOSED_BIT) != 0;
+        }
+
+        /**
+         * @brief Push an element to the queue. If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         * @details Only one thread may call this method.
+         *
+         * @param[in] elem the data to be pushed into the queue
+         * @retval true The data was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        bool push(T_elem elem) {
+            EnqueueResult result = tryEnqueue(elem);
+            if (result == EnqueueResult::FULL) {
+                m_ec_notFull.wait([&]{
+                    result = tryEnqueue(elem);
+                    return result != EnqueueResult::FULL;
+                });
+            }
+            if (result != EnqueueResult::PUSHED) {
+                return false;
+            }
+            /* The exchange publishing the element is sequentially consistent, so a consumer which found the queue empty is already counted here. */
+            if (m_ec_notEmpty.hasWaiters()) {
+                m_ec_notEmpty.notifyOne();
+            }
+            return true;
+        }
+
+        /**
+         * @brief Pop an element from the queue. If the queue is empty, the caller thread is blocked until the queue is not-empty or is closed.
+         * @details Only one thread may call this method.
+         *
+         * @param[out] elem the reference to the data which the popped data to be stored
+         * @retval true The data was successfully popped from the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-empty.
+         */
+        bool pop(T_elem &elem) {
+            bool isPopped = tryDequeue(&elem);
+            if (!isPopped) {
+                m_ec_notEmpty.wait([&]{
+                    isPopped = tryDequeue(&elem);
+                    if (isPopped) {
+                        return true;
+                    }
+                    /* No element is pushed once the inlet is closed, so the ones pushed before are all visible now. */
+                    if (isInletClosed()) {
+                        isPopped = tryDequeue(&elem);
+                        return true;
+                    }
+                    return false;
+                });
+            }
+            if (isPopped) {
+                m_ec_notFull.notifyOne();
+            }
+            return isPopped;
+        }
+
+        /**
+         * @brief Pop all elements from the queue.
+         * @details Only the consumer thread may call this method.
+         * One typically uses this method to abort pending tasks under producer-consumer thread model; calls `closeInlet` method, then calls `popAll` method.
+         */
+        void popAll() {
+            size_t numPopped = 0;
+            while (tryDequeue(nullptr)) {
+                ++numPopped;
+            }
+            if (numPopped > 0) {
+                m_ec_notFull.notifyAll();
+            }
+        }
+
+        /**
+         * @brief Close the queue inlet.
+         * @details After the queue inlet is closed:
+         * @par 1. Following or currently-blocked `push` callings return with `false`.
+         * @par 2. Following or currently-blocked `pop` callings return with `true` as far as there is at least one element in the queue, otherwise return with `false`.
+         */
+        void closeInlet() {
+            m_tail.fetch_or(CLOSED_BIT, std::memory_order_seq_cst);
+            m_ec_notFull.notifyAll();
+            m_ec_notEmpty.notifyAll();
+        }
+};
+
+/**
+ * @brief queue policy to build single-producer single-consumer pipeline stages on `SpscMultiThreadQueue`
+ * @details Not suitable for `BasicThreadPool`, whose worker threads are multiple consumers.
+ */
+struct SpscQueuePolicy {
+    template <typename T_elem>
+    using Queue = SpscMultiThreadQueue<T_elem>;
+};
+
+#endif // __SPSC_MULTI_THREAD_QUEUE__
@@ -0,0 +1,192 @@
+/**
+ * @file TaskFuture.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief lightweight one-shot future for the results of submitted callables
+ * @version 0.2.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __TASK_FUTURE__
+#define __TASK_FUTURE__
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "EventCount.hpp"
+
+/**
+ * @brief state shared by a `TaskFuture` and the task which produces its result
+ * @details The result is published by one release store, and the setter pays for a mutex only when somebody is blocked in `wait` (see `EventCount`).
+ *
+ * @tparam T_result the result type, may be `void`
+ */
+template <typename T_result>
+class TaskState {
+    private:
+        using Value = std::conditional_t<std::is_void_v<T_result>, bool, T_result>; // `void` results store a dummy
+        std::atomic<bool> m_isReady{false};
+        EventCount m_ec_ready;
+        std::optional<Value> m_value;
+        std::exception_ptr m_exception;
+
+        void publish() {
+            m_isReady.store(true, std::memory_order_release);
+            m_ec_ready.notifyAll();
+        }
+
+    public:
+        /**
+         * @brief Call `func` and store its return value, or the exception it throws. Must be called once.
+         */
+        template <typename T_func>
+        void run(T_func &&func) {
+            try {
+                if constexpr (std::is_void_v<T_result>) {
+                    std::forward<T_func>(func)();
+                    m_value.emplace(true);
+                } else {
+                    m_value.emplace(std::forward<T_func>(func)());
+                }
+            } catch (...) {
+                m_exception = std::current_exception();
+            }
+            publish();
+        }
+
+        /**
+         * @brief Store `std::future_error(std::future_errc::broken_promise)` as the result, for a task destroyed without having run. Must be called at most once, instead of `run`.
+         */
+        void breakPromise() {
+            m_exception = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            publish();
+        }
+
+        /**
+         * @brief Check if the result is ready
+         */
+        bool isReady() const {return m_isReady.load(std::memory_order_acquire);}
+
+        /**
+         * @brief Block the caller thread until the result is ready.
+         */
+        void wait() {
+            if (isReady()) {
+                return;
+            }
+            m_ec_ready.wait([this]{return isReady();});
+        }
+
+        /**
+         * @brief Wait for the result, then move it out, or rethrow the exception thrown by the task.
+         */
+        T_result take() {
+            wait();
+            if (m_exception) {
+                std::rethrow_exception(m_exception);
+            }
+            if constexpr (!std::is_void_v<T_result>) {
+                return std::move(*m_value);
+            }
+        }
+};
+
+/**
+ * @brief the setter side of a `TaskState`, held by the submitted task
+ * @details If it is destroyed before `run` is called, e.g. with a task discarded by `BasicThreadPool::popAllExecutables` or left in the queue of a destroyed pool, the future reports `std::future_errc::broken_promise` instead of waiting forever.
+ *
+ * @tparam T_result the result type, may be `void`
+ */
+template <typename T_result>
+class TaskPromise {
+    private:
+        std::shared_ptr<TaskState<T_result>> m_state;
+
+    public:
+        /**
+         * @brief Construct a new TaskPromise object which sets `state`
+         */
+        explicit TaskPromise(std::shared_ptr<TaskState<T_result>> state) : m_state(std::move(state)) {}
+
+        TaskPromise(TaskPromise &&) noexcept = default;
+        TaskPromise &operator=(TaskPromise &&) = delete;
+        TaskPromise(const TaskPromise &) = delete;
+        TaskPromise &operator=(const TaskPromise &) = delete;
+
+        ~TaskPromise() {
+            if (m_state) {
+                m_state->breakPromise();
+            }
+        }
+
+        /**
+         * @brief Call `func` and store its return value, or the exception it throws. Must be called at most once.
+         */
+        template <typename T_func>
+        void run(T_func &&func) {
+            const std::shared_ptr<TaskState<T_result>> state = std::move(m_state);
+            state->run(std::forward<T_func>(func));
+        }
+};
+
+/**
+ * @brief one-shot future returned by `BasicThreadPool::submit`
+ * @details Unlike `std::future`, it has no mutex on the setter side; a task which nobody waits for publishes its result with one atomic store.
+ * Calling `wait`/`get` from inside a pooled thread of the same pool can deadlock when all the pooled threads wait.
+ *
+ * @tparam T_result the result type, may be `void`
+ */
+template <typename T_result>
+class TaskFuture {
+    private:
+        std::shared_ptr<TaskState<T_result>> m_state;
+
+    public:
+        /**
+         * @brief Construct an invalid TaskFuture object
+         */
+        TaskFuture() = default;
+
+        /**
+         * @brief Construct a new TaskFuture object which refers to `state`
+         */
+        explicit TaskFuture(std::shared_ptr<TaskState<T_result>> state) : m_state(std::move(state)) {}
+
+        TaskFuture(TaskFuture &&) = default;
+        TaskFuture &operator=(TaskFuture &&) = default;
+        TaskFuture(const TaskFuture &) = delete;
+        TaskFuture &operator=(const TaskFuture &) = delete;
+
+        /**
+         * @brief Check if the future refers to a task. A future returned for a task which could not be submitted (the pool was closed) is invalid.
+         */
+        bool valid() const {return static_cast<bool>(m_state);}
+
+        /**
+         * @brief Check if the result is ready, without blocking. Must be valid.
+         */
+        bool isReady() const {return m_state->isReady();}
+
+        /**
+         * @brief Block the caller thread until the result is ready. Must be valid.
+         */
+        void wait() const {m_state->wait();}
+
+        /**
+         * @brief Wait for the result and return it, or rethrow the exception thrown by the task. Must be valid; the future becomes invalid.
+         *
+         * @return the result of the task
+         */
+        T_result get() {
+            std::shared_ptr<TaskState<T_result>> state = std::move(m_state);
+            return state->take();
+        }
+};
+
+#endif // __TASK_FUTURE__
@@ -0,0 +1,260 @@
+/**
+ * @file TaskGraph.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief reusable task dependency graph (DAG) run on a thread pool
+ * @version 0.1.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __TASK_GRAPH__
+#define __TASK_GRAPH__
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "EventCount.hpp"
+
+/**
+ * @brief task dependency graph: nodes are tasks, and an edge from node A to node B makes B run after A
+ * @details The graph is built once and run as many times as needed, e.g. once per frame.
+ * Each node has an atomic counter of the predecessors not finished yet, reset at the start of every run;
+ * the thread finishing the last predecessor of a node makes the node ready at once, so no thread waits for a whole stage to finish.
+ * That thread runs one ready successor itself (no queueing latency along a chain) and hands the others to the pool, one pool task per node (by `tryPost`, so a full queue never blocks it).
+ * The caller of `run` runs ready nodes too, so a run also completes when all the pooled threads are busy.
+ *
+ * Nodes and edges must not be added while the graph is running, and one graph must not be run by two threads at a time.
+ */
+class TaskGraph {
+    public:
+        using NodeId = size_t;
+
+    private:
+        struct Node {
+            std::function<void()> work;
+            std::vector<NodeId> successors;
+            size_t numPredecessors = 0;
+            std::atomic<size_t> numPending{0}; // the predecessors not finished yet in the current run
+        };
+
+        /**
+         * @brief the nodes and the state of the current run, shared with the pool tasks which may start after the run (or the graph) has finished
+         */
+        struct State {
+            std::deque<Node> nodes;
+            std::mutex readyMtx;
+            std::vector<NodeId> ready; // the nodes whose predecessors have all finished and which nobody has claimed yet, guarded by `readyMtx`
+            std::atomic<size_t> numReady{0}; // `ready.size()`, read without the lock
+            std::atomic<size_t> numRemaining{0}; // the nodes not finished yet in the current run
+            EventCount ec_run; // notified when a node becomes ready or the last node finishes
+            std::atomic<bool> isFailed{false};
+            std::exception_ptr exception; // the first exception thrown by a node, guarded by `readyMtx`
+
+            bool claimReady(NodeId &id) {
+                if (numReady.load(std::memory_order_acquire) == 0) {
+                    return false;
+                }
+                std::lock_guard<std::mutex> lock(readyMtx);
+                if (ready.empty()) {
+                    return false;
+                }
+                id = ready.back();
+                ready.pop_back();
+                numReady.store(ready.size(), std::memory_order_release);
+                return true;
+            }
+
+            template <typename T_pool>
+            static void pushReady(const std::shared_ptr<State> &state, T_pool &pool, NodeId id) {
+                {
+                    std::lock_guard<std::mutex> lock(state->readyMtx);
+                    state->ready.push_back(id);
+                    state->numReady.store(state->ready.size(), std::memory_order_release);
+                }
+                state->ec_run.notifyAll();
+                /* The pool task runs whichever nodes are ready when it starts, if any. If the pool is closed or full, the node waits for the threads already running the graph. */
+                pool.tryPost([state, &pool]{
+                    NodeId claimed;
+                    while (state->claimReady(claimed)) {
+                        runChain(state, pool, claimed);
+                    }
+                });
+            }
+
+            /**
+             * @brief Run a node, then one of its successors which became ready, and so on; the other successors which became ready are handed to the pool.
+             */
+            template <typename T_pool>
+            static void runChain(const std::shared_ptr<State> &state, T_pool &pool, NodeId id) {
+                for (;;) {
+                    Node &node = state->nodes[id];
+                    if (!state->isFailed.load(std::memory_order_relaxed)) {
+                        try {
+                            node.work();
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(state->readyMtx);
+                            if (!state->exception) {
+                                state->exception = std::current_exception();
+                                state->isFailed.store(true, std::memory_order_release);
+                            }
+                        }
+                    }
+                    bool hasNext = false;
+                    NodeId next = 0;
+                    for (const NodeId succ : node.successors) {
+                        if (state->nodes[succ].numPending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                            continue;
+                        }
+                        if (!hasNext) {
+                            hasNext = true;
+                            next = succ;
+                        } else {
+                            pushReady(state, pool, succ);
+                        }
+                    }
+                    if (state->numRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        state->ec_run.notifyAll();
+                    }
+                    if (!hasNext) {
+                        return;
+                    }
+                    id = next;
+                }
+            }
+        };
+
+        const std::shared_ptr<State> m_state = std::make_shared<State>();
+        bool m_isChecked = false; // The graph has been checked to be acyclic since the last change.
+        bool m_isAcyclic = false;
+
+        bool checkAcyclic() const;
+
+    public:
+        /**
+         * @brief Add a node.
+         *
+         * @param[in] work the task, called once per run in a pooled thread or the caller thread of `run`
+         * @return the id of the node, numbered from 0 in the order of addition
+         */
+        NodeId addNode(std::function<void()> work) {
+            m_state->nodes.emplace_back();
+            m_state->nodes.back().work = std::move(work);
+            m_isChecked = false;
+            return m_state->nodes.size() - 1;
+        }
+
+        /**
+         * @brief Add an edge: `to` runs after `from` has finished.
+         *
+         * @param[in] from the id of the predecessor, returned by `addNode`
+         * @param[in] to the id of the successor, returned by `addNode`
+         */
+        void addEdge(NodeId from, NodeId to) {
+            assert((from < numNodes()) && (to < numNodes()));
+            m_state->nodes[from].successors.push_back(to);
+            ++m_state->nodes[to].numPredecessors;
+            m_isChecked = false;
+        }
+
+        /**
+         * @brief Get the number of the nodes
+         */
+        size_t numNodes() const {return m_state->nodes.size();}
+
+        /**
+         * @brief Run every node once, each as soon as all its predecessors have finished, and return when all the nodes have finished.
+         * @details The caller thread runs the ready nodes which no pooled thread has started, so this method may be called from a pooled thread (i.e. from `Executable::run`).
+         *
+         * @tparam T_pool thread pool type with `tryPost`
+         * @param[in] pool the pool to run the nodes on
+         * @retval true All the nodes have run.
+         * @retval false The graph has a cycle; no node has run.
+         * @throw the first exception thrown by a node, after all the running nodes have finished; the nodes not started are skipped
+         */
+        template <typename T_pool>
+        bool run(T_pool &pool) {
+            if (!m_isChecked) {
+                m_isAcyclic = checkAcyclic();
+                m_isChecked = true;
+            }
+            if (!m_isAcyclic) {
+                return false;
+            }
+            State &state = *m_state;
+            if (state.nodes.empty()) {
+                return true;
+            }
+
+            state.isFailed.store(false, std::memory_order_relaxed);
+            state.exception = nullptr;
+            state.numRemaining.store(state.nodes.size(), std::memory_order_relaxed);
+            for (Node &node : state.nodes) {
+                node.numPending.store(node.numPredecessors, std::memory_order_relaxed);
+            }
+            bool hasFirst = false;
+            NodeId first = 0;
+            for (NodeId id=0; id<state.nodes.size(); ++id) {
+                if (state.nodes[id].numPredecessors > 0) {
+                    continue;
+                }
+                if (!hasFirst) {
+                    hasFirst = true;
+                    first = id;
+                } else {
+                    State::pushReady(m_state, pool, id); // The release store of `numReady` publishes the resets above to the pooled threads.
+                }
+            }
+
+            State::runChain(m_state, pool, first);
+            /* Help with the nodes which no pooled thread may be free to run. */
+            for (;;) {
+                state.ec_run.wait([&state]{return (state.numRemaining.load(std::memory_order_acquire) == 0) || (state.numReady.load(std::memory_order_acquire) > 0);});
+                NodeId id;
+                if (state.claimReady(id)) {
+                    State::runChain(m_state, pool, id);
+                } else if (state.numRemaining.load(std::memory_order_acquire) == 0) {
+                    break;
+                }
+            }
+            if (state.isFailed.load(std::memory_order_acquire)) {
+                std::rethrow_exception(state.exception);
+            }
+            return true;
+        }
+};
+
+inline bool TaskGraph::checkAcyclic() const {
+    /* Kahn's algorithm: the graph is acyclic iff every node is removed by repeatedly removing the nodes without remaining predecessors. */
+    const std::deque<Node> &nodes = m_state->nodes;
+    std::vector<size_t> numPending(nodes.size());
+    std::vector<NodeId> roots;
+    for (NodeId id=0; id<nodes.size(); ++id) {
+        numPending[id] = nodes[id].numPredecessors;
+        if (numPending[id] == 0) {
+            roots.push_back(id);
+        }
+    }
+    size_t numRemoved = 0;
+    while (!roots.empty()) {
+        const NodeId id = roots.back();
+        roots.pop_back();
+        ++numRemoved;
+        for (const NodeId succ : nodes[id].successors) {
+            if (--numPending[succ] == 0) {
+                roots.push_back(succ);
+            }
+        }
+    }
+    return numRemoved == nodes.size();
+}
+
+#endif // __TASK_GRAPH__
@@ -0,0 +1,183 @@
+/**
+ * @file TaskGroup.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief fork-join task group whose `wait` runs pending work instead of blocking
+ * @version 0.2.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __TASK_GROUP__
+#define __TASK_GROUP__
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include "EventCount.hpp"
+#include "InlineTask.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief structured fork-join on a thread pool: `run` forks tasks, `wait` joins them
+ * @details Waiting for subtasks inside a pool task with futures blocks the pooled thread, and the pool deadlocks once every pooled thread waits.
+ * `wait` of a task group never sleeps while there is something it can run instead:
+ * @par 1. the tasks of this group which no thread has started, newest first (depth first, like a sequential recursion), then
+ * @par 2. on a pooled thread, any pending task of the pool (`BasicThreadPool::runPendingTask`).
+ * It sleeps only while the remaining tasks of the group are running on other threads. So recursive divide-and-conquer is safe on any number of pooled threads, even one.
+ * Each forked task is also offered to the pool by `tryPost`; an idle pooled thread takes the oldest (i.e. the largest, in a recursion) task of the group.
+ *
+ * `run` may be called from any thread, including the tasks of the group; `wait` must be called by one thread at a time.
+ *
+ * @tparam T_pool thread pool type with `tryPost` and `runPendingTask`
+ */
+template <typename T_pool = ThreadPool>
+class TaskGroup {
+    private:
+        /**
+         * @brief the state shared with the helper tasks in the pool, which may start after the group is destroyed
+         */
+        struct State {
+            std::mutex mtx;
+            std::deque<InlineTask<>> pending; // the tasks not started yet, guarded by `mtx`
+            std::atomic<size_t> numPending{0}; // `pending.size()`, read without the lock
+            std::atomic<size_t> numUnfinished{0}; // the tasks forked and not finished yet
+            EventCount ec_wait; // notified when a task is forked or the last task finishes
+            std::atomic<bool> isFailed{false};
+            std::exception_ptr exception; // the first exception thrown by a task, guarded by `mtx`
+
+            /**
+             * @brief Take the oldest or the newest pending task.
+             */
+            bool claim(InlineTask<> &task, bool isNewest) {
+                if (numPending.load(std::memory_order_acquire) == 0) {
+                    return false;
+                }
+                std::lock_guard<std::mutex> lock(mtx);
+                if (pending.empty()) {
+                    return false;
+                }
+                if (isNewest) {
+                    task = std::move(pending.back());
+                    pending.pop_back();
+                } else {
+                    task = std::move(pending.front());
+                    pending.pop_front();
+                }
+                numPending.store(pending.size(), std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * @brief Run a claimed task, unless a task of the group has failed, and count it finished.
+             */
+            void runClaimed(InlineTask<> &task) {
+                if (!isFailed.load(std::memory_order_relaxed)) {
+                    try {
+                        task();
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mtx);
+                        if (!exception) {
+                            exception = std::current_exception();
+                            isFailed.store(true, std::memory_order_release);
+                        }
+                    }
+                }
+                task.reset(); // Destroy the captures before the waiter may return.
+                if (numUnfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    ec_wait.notifyAll();
+                }
+            }
+        };
+
+        T_pool &m_pool;
+        const std::shared_ptr<State> m_state = std::make_shared<State>();
+
+    public:
+        /**
+         * @brief Construct a new TaskGroup object
+         *
+         * @param[in] pool the pool to run the tasks on
+         */
+        explicit TaskGroup(T_pool &pool) : m_pool(pool) {}
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        /**
+         * @brief Destroy the TaskGroup object, after waiting for its tasks as `wait` (an exception thrown by a task is discarded).
+         */
+        ~TaskGroup() {
+            try {
+                wait();
+            } catch (...) {}
+        }
+
+        /**
+         * @brief Fork a task: call `func(args...)` later, in a pooled thread or in the thread calling `wait`.
+         * @details `func` and `args` are stored in an `InlineTask`, without heap allocation if they fit in `InlineTask::INLINE_SIZE` bytes (besides the pending list of the group).
+         *
+         * @tparam T_func callable type
+         * @tparam T_args the types of the arguments
+         * @param[in] func the callable
+         * @param[in] args the arguments, decay-copied (or moved) into the task as `BasicThreadPool::post`; pass `std::ref(x)` to let the task write `x`, e.g. a partial result
+         */
+        template <typename T_func, typename... T_args>
+        void run(T_func &&func, T_args&&... args) {
+            State &state = *m_state;
+            InlineTask<> task(makeDeferredCall(std::forward<T_func>(func), std::forward<T_args>(args)...));
+            {
+                /* Count the task only once it is queued, so that a throwing copy of an argument or allocation leaves the group as it was. Under the lock, nobody can claim and finish the task before it is counted. */
+                std::lock_guard<std::mutex> lock(state.mtx);
+                state.pending.push_back(std::move(task));
+                state.numUnfinished.fetch_add(1, std::memory_order_relaxed);
+                state.numPending.store(state.pending.size(), std::memory_order_release);
+            }
+            state.ec_wait.notifyAll();
+            /* The helper runs the oldest pending task of the group when it starts, if any. If the pool is closed or full, the task waits for `wait`. */
+            m_pool.tryPost([state = m_state]{
+                InlineTask<> claimed;
+                if (state->claim(claimed, false)) {
+                    state->runClaimed(claimed);
+                }
+            });
+        }
+
+        /**
+         * @brief Wait until all the forked tasks have finished, running pending tasks meanwhile. The group can be reused afterwards.
+         *
+         * @throw the first exception thrown by a task of the group; the tasks not started after the exception are skipped
+         */
+        void wait() {
+            State &state = *m_state;
+            InlineTask<> task;
+            while (state.numUnfinished.load(std::memory_order_acquire) != 0) {
+                if (state.claim(task, true)) {
+                    state.runClaimed(task);
+                    continue;
+                }
+                if (m_pool.runPendingTask()) {
+                    continue;
+                }
+                state.ec_wait.wait([&state]{return (state.numUnfinished.load(std::memory_order_acquire) == 0) || (state.numPending.load(std::memory_order_acquire) > 0);});
+            }
+            if (state.isFailed.load(std::memory_order_acquire)) {
+                std::exception_ptr exception;
+                {
+                    std::lock_guard<std::mutex> lock(state.mtx);
+                    exception = std::move(state.exception);
+                    state.exception = nullptr;
+                    state.isFailed.store(false, std::memory_order_relaxed);
+                }
+                std::rethrow_exception(exception);
+            }
+        }
+};
+
+#endif // __TASK_GROUP__
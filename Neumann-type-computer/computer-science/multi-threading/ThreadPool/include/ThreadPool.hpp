@@ -2,8 +2,8 @@
  * @file ThreadPool.hpp
  * @author motchy (motchy869@gmail.com)
  * @brief thread pool
- * @version 0.1.0
- * @date 2021-07-29
+ * @version 0.12.0
+ * @date 2026-10-17
  * @copyright Copyright (c) 2021 motchy
  * https://motchy869.com/wordpress/
  * Released under the MIT license
@@ -12,10 +12,24 @@
 #ifndef __THREAD_POOL__
 #define __THREAD_POOL__
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "InlineTask.hpp"
+#include "LockFreeMultiThreadQueue.hpp"
 #include "MultiThreadQueue.hpp"
+#include "ParallelLoop.hpp"
+#include "PriorityMultiThreadQueue.hpp"
+#include "ShardedMultiThreadQueue.hpp"
+#include "TaskFuture.hpp"
 
 /**
  * @brief struct for hold information of a worker thread.
@@ -42,27 +56,200 @@ class Executable {
          */
         virtual void run(ThreadInfo threadInfo) = 0;
 
+        /**
+         * @brief Get the priority of this object. A thread pool built with `PriorityQueuePolicy` runs higher-priority objects first.
+         *
+         * @return priority, 0 by default
+         */
+        virtual int getPriority() const {return 0;}
+
         /**
          * @brief Destroy the Executable object
          */
         virtual ~Executable() {}
 };
 
-class ThreadPool {
+/**
+ * @brief a callable and its arguments stored for a later call, made by `makeDeferredCall`
+ *
+ * @tparam T_func decayed callable type
+ * @tparam T_args the decayed types of the arguments
+ */
+template <typename T_func, typename... T_args>
+class DeferredCall {
     private:
+        std::tuple<T_func, T_args...> m_call;
+
+    public:
+        using Result = std::invoke_result_t<T_func, T_args...>;
+
+        explicit DeferredCall(std::tuple<T_func, T_args...> call) : m_call(std::move(call)) {}
+
+        /**
+         * @brief Call the callable with the stored arguments, moving them out. Call this at most once.
+         */
+        Result operator()() {
+            return std::apply([](auto &f, auto &...a) -> Result {return std::invoke(std::move(f), std::move(a)...);}, m_call);
+        }
+};
+
+/**
+ * @brief Store a callable and its arguments for a later call, decay-copying (or moving) them as `std::thread` does.
+ * @details Pass `std::ref(x)` to bind `x` to a reference parameter of the callable.
+ *
+ * @param[in] func the callable
+ * @param[in] args the arguments
+ * @return the object which calls `func(args...)` when called
+ */
+template <typename T_func, typename... T_args>
+DeferredCall<std::decay_t<T_func>, std::decay_t<T_args>...> makeDeferredCall(T_func &&func, T_args&&... args) {
+    return DeferredCall<std::decay_t<T_func>, std::decay_t<T_args>...>(std::tuple<std::decay_t<T_func>, std::decay_t<T_args>...>(std::forward<T_func>(func), std::forward<T_args>(args)...));
+}
+
+/**
+ * @brief move-only task object carried by the queue of `BasicThreadPool`: either an `Executable` object or a callable taking `ThreadInfo`
+ * @details The task is stored in an `InlineTask`, so submitting a callable of up to `INLINE_SIZE` bytes whose move constructor does not throw allocates nothing;
+ * larger callables are allocated on the heap. An `Executable` object is held by its `std::shared_ptr`, which is always stored inside.
+ */
+class PoolTask {
+    public:
+        static constexpr size_t INLINE_SIZE = InlineTask<ThreadInfo>::INLINE_SIZE;
+
+    private:
+        struct ExecutableHolder {
+            std::shared_ptr<Executable> exe;
+            void operator()(ThreadInfo threadInfo) {exe->run(threadInfo);}
+        };
+
+        InlineTask<ThreadInfo> m_task;
+
+    public:
+        /**
+         * @brief Construct an empty PoolTask object
+         */
+        PoolTask() = default;
+
+        /**
+         * @brief Construct a new PoolTask object which runs an Executable object
+         *
+         * @param[in] ptr_exe std::shared_ptr of an Executable object
+         */
+        explicit PoolTask(std::shared_ptr<Executable> ptr_exe) : m_task(ExecutableHolder{std::move(ptr_exe)}) {}
+
+        /**
+         * @brief Construct a new PoolTask object which runs a callable
+         *
+         * @tparam T_func callable type which takes `ThreadInfo`
+         * @param[in] func the callable, moved or copied into the object
+         */
+        template <typename T_func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T_func>, PoolTask> && std::is_invocable_v<std::decay_t<T_func> &, ThreadInfo>>>
+        explicit PoolTask(T_func &&func) : m_task(std::forward<T_func>(func)) {}
+
+        /**
+         * @brief Check if the object holds a task
+         */
+        explicit operator bool() const {return static_cast<bool>(m_task);}
+
+        /**
+         * @brief Destroy the held task, if any.
+         */
+        void reset() {m_task.reset();}
+
+        /**
+         * @brief Run the held task in current thread. The object must hold a task.
+         */
+        void operator()(ThreadInfo threadInfo) {m_task(threadInfo);}
+
+        /**
+         * @brief Get the priority of the held task: `Executable::getPriority` for an Executable object, 0 for a callable. The object must hold a task.
+         */
+        int getPriority() const {
+            const ExecutableHolder *holder = m_task.target<ExecutableHolder>();
+            return (holder != nullptr) ? holder->exe->getPriority() : 0;
+        }
+
+        /**
+         * @brief Convert the held task to an Executable object, which takes it over. The object must hold a task and becomes empty.
+         * @details An Executable object is returned as is; a callable is wrapped in a newly allocated Executable object.
+         *
+         * @return std::shared_ptr of the Executable object
+         */
+        std::shared_ptr<Executable> toExecutable() &&;
+};
+
+/**
+ * @brief Executable object which runs a callable taken out of a `PoolTask`, e.g. by `BasicThreadPool::drainExecutables`
+ */
+class PoolTaskExecutable : public Executable {
+    private:
+        PoolTask m_task;
+
+    public:
+        explicit PoolTaskExecutable(PoolTask task) : m_task(std::move(task)) {}
+
+        const char *getDescriptionString() override {return "PoolTaskExecutable";}
+        void run(ThreadInfo threadInfo) override {m_task(threadInfo);}
+};
+
+inline std::shared_ptr<Executable> PoolTask::toExecutable() && {
+    if (ExecutableHolder *holder = m_task.target<ExecutableHolder>()) {
+        std::shared_ptr<Executable> exe = std::move(holder->exe);
+        reset();
+        return exe;
+    }
+    return std::make_shared<PoolTaskExecutable>(std::move(*this));
+}
+
+/**
+ * @brief ordering of `std::shared_ptr<Executable>` and `PoolTask` by `Executable::getPriority`
+ */
+struct ExecutablePriorityLess {
+    bool operator()(const std::shared_ptr<Executable> &a, const std::shared_ptr<Executable> &b) const {return a->getPriority() < b->getPriority();}
+    bool operator()(const PoolTask &a, const PoolTask &b) const {return a.getPriority() < b.getPriority();}
+};
+
+/**
+ * @brief queue policy to build `BasicThreadPool` on `PriorityMultiThreadQueue`, which runs `Executable` objects roughly in the order of `Executable::getPriority`
+ */
+struct PriorityQueuePolicy {
+    template <typename T_elem>
+    using Queue = PriorityMultiThreadQueue<T_elem, ExecutablePriorityLess>;
+};
+
+/**
+ * @brief thread pool
+ *
+ * @tparam T_queuePolicy queue policy which selects the queue type for sending Executable objects to pooled threads, e.g. `MutexQueuePolicy`, `LockFreeQueuePolicy`, `ShardedQueuePolicy` or `PriorityQueuePolicy`
+ */
+template <typename T_queuePolicy = MutexQueuePolicy>
+class BasicThreadPool {
+    private:
+        using ExecutableQueue = typename T_queuePolicy::template Queue<PoolTask>;
+
         const unsigned int m_numThreads;
         std::vector<std::thread> m_threads;
-        std::mutex m_threadsMtx;
-        MultiThreadQueue<std::shared_ptr<Executable>> m_queue;
+        std::mutex m_threadsMtx; // held while the threads are being created
+        std::mutex m_joinMtx; // serializes `join`, separate from `m_threadsMtx` which the pooled threads lock at startup
+        ExecutableQueue m_queue;
+        std::mutex m_batchMtx;
+        std::condition_variable m_cv_batch; // notified when a pooled thread becomes idle, a new batch starts or the pool is closed
+        unsigned int m_numIdleThreads = 0; // the number of the pooled threads which finished the current batch, guarded by `m_batchMtx`
+        size_t m_batchGeneration = 0; // guarded by `m_batchMtx`
+        bool m_isClosed = false; // guarded by `m_batchMtx`
+
+        /**
+         * @brief the loop of a pooled thread, which runs Executable objects batch after batch until the pool is closed
+         */
+        void thread_runExecutables(ThreadInfo threadInfo);
 
     public:
         /**
-         * @brief Construct a new ThreadPool object
+         * @brief Construct a new BasicThreadPool object
          *
          * @param[in] numThreads the number of the threads to be created
          * @param[in] queueDepth the depth of the queue for sending Executable object to pooled threads
          */
-        ThreadPool(unsigned int numThreads, unsigned int queueDepth);
+        BasicThreadPool(unsigned int numThreads, unsigned int queueDepth);
 
         /**
          * @brief Get the number of the pooled threads
@@ -79,12 +266,164 @@ class ThreadPool {
          * @retval true The object was successfully pushed into the queue.
          * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
          */
-        bool pushExecutable(std::shared_ptr<Executable> ptr_exe) {return m_queue.push(ptr_exe);}
+        bool pushExecutable(std::shared_ptr<Executable> ptr_exe) {return m_queue.push(PoolTask(std::move(ptr_exe)));}
+
+        /**
+         * @brief Construct a new Executable object and push it to the queue.
+         * @details If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         *
+         * @tparam T_executable concrete class inheriting `Executable`
+         * @tparam T_args the types of the constructor arguments
+         * @param[in] args the arguments forwarded to the constructor of `T_executable`
+         * @retval true The object was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        template <typename T_executable, typename... T_args>
+        bool emplaceExecutable(T_args&&... args) {return m_queue.push(PoolTask(std::make_shared<T_executable>(std::forward<T_args>(args)...)));}
+
+        /**
+         * @brief Push a callable to the queue, without waiting for or returning its result.
+         * @details `func` and `args` are stored in the task object, so no heap allocation happens if they fit in `PoolTask::INLINE_SIZE` bytes.
+         * If the queue is full, the caller thread is blocked until the queue is not-full or is closed.
+         *
+         * @tparam T_func callable type
+         * @tparam T_args the types of the arguments
+         * @param[in] func the callable, called as `func(args...)` in a pooled thread
+         * @param[in] args the arguments, decay-copied (or moved) into the task as `std::thread` does; pass `std::ref(x)` to bind `x` to a reference parameter
+         * @retval true The callable was successfully pushed into the queue.
+         * @retval false The queue was already closed, or became closed during waiting for the queue to be not-full.
+         */
+        template <typename T_func, typename... T_args>
+        bool post(T_func &&func, T_args&&... args) {
+            return m_queue.push(PoolTask(
+                [call = makeDeferredCall(std::forward<T_func>(func), std::forward<T_args>(args)...)](ThreadInfo) mutable {call();}
+            ));
+        }
+
+        /**
+         * @brief Push a callable to the queue as `post`, but without blocking.
+         * @details Meant for helper tasks which are optional, e.g. the ones pushed by `parallelFor` and `TaskGraph`: a pooled thread pushing to the full queue it drains itself would wait forever with `post`.
+         *
+         * @tparam T_func callable type
+         * @tparam T_args the types of the arguments
+         * @param[in] func the callable, called as `func(args...)` in a pooled thread
+         * @param[in] args the arguments, decay-copied (or moved) into the task as `post`
+         * @retval true The callable was pushed into the queue.
+         * @retval false The queue was closed or full.
+         */
+        template <typename T_func, typename... T_args>
+        bool tryPost(T_func &&func, T_args&&... args) {
+            PoolTask task(
+                [call = makeDeferredCall(std::forward<T_func>(func), std::forward<T_args>(args)...)](ThreadInfo) mutable {call();}
+            );
+            if constexpr (std::is_same_v<decltype(m_queue.tryPush(task)), QueueOpStatus>) {
+                return m_queue.tryPush(std::move(task)) == QueueOpStatus::SUCCESS;
+            } else {
+                return m_queue.tryPush(task);
+            }
+        }
+
+        /**
+         * @brief Push a callable to the queue and return the future of its result.
+         * @details As `post`, but the result (or the exception thrown) is delivered through the returned `TaskFuture`, whose shared state is the only heap allocation.
+         * Prefer `post` for tasks whose result is not needed.
+         *
+         * @tparam T_func callable type
+         * @tparam T_args the types of the arguments
+         * @param[in] func the callable, called as `func(args...)` in a pooled thread
+         * @param[in] args the arguments, decay-copied (or moved) into the task as `post`
+         * @return the future of the result, which is invalid (`TaskFuture::valid` returns `false`) if the queue was closed.
+         * If the task is destroyed without having run (e.g. by `popAllExecutables`), `get` throws `std::future_error` with `std::future_errc::broken_promise`.
+         */
+        template <typename T_func, typename... T_args>
+        auto submit(T_func &&func, T_args&&... args) -> TaskFuture<std::invoke_result_t<std::decay_t<T_func>, std::decay_t<T_args>...>> {
+            using Result = std::invoke_result_t<std::decay_t<T_func>, std::decay_t<T_args>...>;
+            auto state = std::make_shared<TaskState<Result>>();
+            TaskFuture<Result> future(state);
+            const bool isPushed = m_queue.push(PoolTask(
+                [promise = TaskPromise<Result>(std::move(state)), call = makeDeferredCall(std::forward<T_func>(func), std::forward<T_args>(args)...)](ThreadInfo) mutable {
+                    promise.run(call);
+                }
+            ));
+            return isPushed ? std::move(future) : TaskFuture<Result>();
+        }
+
+        /**
+         * @brief Call `body` for every index of `range`, in parallel on the caller thread and the pooled threads, and return when all the calls have returned.
+         * @details The range is split recursively by lazy binary splitting: a thread splits off half of its remaining indices only when no split-off half is waiting to be taken, so idle pooled threads get work quickly and busy ones pay no splitting cost.
+         * The caller thread runs indices too, including the ones the pooled threads have not started, so this method also completes when all the pooled threads are busy; it may be called from a pooled thread (i.e. from `Executable::run`).
+         * The helper tasks are pushed by `tryPost`; while the queue is full, the threads already in the loop run the split-off indices themselves.
+         *
+         * @tparam T_body callable type taking either `size_t` (an index) or `IndexRange` (a chunk of up to `ParallelOptions::grainSize` indices)
+         * @param[in] range the index range
+         * @param[in] body the loop body, called concurrently from several threads
+         * @param[in] options the chunk size
+         * @throw the first exception thrown by `body`; the indices not run yet are skipped
+         */
+        template <typename T_body>
+        void parallelFor(IndexRange range, T_body &&body, const ParallelOptions &options = ParallelOptions()) {
+            ::parallelFor(*this, range, body, options);
+        }
+
+        /**
+         * @brief Reduce the results of `body` over `range` with `combine`, in parallel on the caller thread and the pooled threads, as `parallelFor`.
+         * @details `combine` must be associative and `identity` must be its identity element.
+         * By default the partial results are combined in the order the threads finish, which changes e.g. the rounding of floating-point sums from run to run.
+         * With `ParallelOptions::isDeterministic`, the partial result of every chunk is kept and they are combined in index order, so the result depends only on `grainSize`
+         * (the automatic `grainSize` depends on the number of the pooled threads; set it explicitly for results reproducible across pools).
+         *
+         * @tparam T_value the result type
+         * @tparam T_body callable type taking either `size_t` (returns the value of an index) or `IndexRange` (returns the partial result of a chunk)
+         * @tparam T_combine callable type taking two `T_value`s and returning their combination
+         * @param[in] range the index range
+         * @param[in] identity the identity element of `combine`, also the result for an empty range
+         * @param[in] body the loop body, called concurrently from several threads
+         * @param[in] combine the combining function, called concurrently from several threads
+         * @param[in] options the chunk size and the determinism
+         * @return the combination of the results of `body` over `range`
+         * @throw the first exception thrown by `body` or `combine`
+         */
+        template <typename T_value, typename T_body, typename T_combine>
+        T_value parallelReduce(IndexRange range, const T_value &identity, T_body &&body, T_combine &&combine, const ParallelOptions &options = ParallelOptions()) {
+            return ::parallelReduce(*this, range, identity, body, combine, options);
+        }
+
+        /**
+         * @brief Run one pending task in the caller thread, if the caller is a pooled thread of this pool and the queue is not empty.
+         * @details Lets a task which waits for other tasks (e.g. `TaskGroup::wait`) run queued work instead of blocking its pooled thread.
+         * The task is run with the `ThreadInfo` of the caller. Other threads cannot help this way, since tasks may rely on `ThreadInfo::threadId` being a pooled thread.
+         *
+         * @retval true A task was run.
+         * @retval false The caller is not a pooled thread of this pool, or the queue was empty.
+         */
+        bool runPendingTask();
+
+        /**
+         * @brief Take all the pending Executable objects out of the queue and return them to the caller.
+         * @details The queue lock is held for a constant time (`MutexQueuePolicy`), so pushers are not stalled however deep the queue is.
+         * Callables pushed by `post`/`submit` are returned wrapped in `PoolTaskExecutable` objects.
+         * One typically calls `closeInlet` method, then calls this method to abort pending tasks and requeue, persist or destroy them later.
+         *
+         * @return the pending Executable objects, in the order they would have run (roughly, with the relaxed policies)
+         */
+        std::deque<std::shared_ptr<Executable>> drainExecutables();
 
         /**
          * @brief Pops all Executable objects from the queue.
+         * @details The objects are destroyed after the queue lock is released.
          */
-        void popAllExecutables() {m_queue.popAll();}
+        void popAllExecutables() {m_queue.drain();}
+
+        /**
+         * @brief Wait until all the Executable objects pushed so far have run, then accept the next batch, keeping the pooled threads and the queue.
+         * @details Pushing is refused (`pushExecutable` returns `false`) while this method waits.
+         * One typically pushes a batch, calls this method, then pushes the next batch, instead of re-creating the pool for every batch.
+         * Must not be called by more than one thread at a time.
+         *
+         * @retval true All the Executable objects have run and the pool accepts the next batch.
+         * @retval false The pool was closed by `closeInlet`.
+         */
+        bool finishBatch();
 
         /**
          * @brief Close the queue inlet. No more Executable objects can be pushed after this operation.
@@ -92,7 +431,7 @@ class ThreadPool {
          * @par 1. following or currently-blocked `pushExecutable` callings return with `false`.
          * @par 2. After the queue becomes empty, each pooled thread waiting for a new Executable object shuts down; i.e. all the pooled threads eventually shut down.
          */
-        void closeInlet() {m_queue.closeInlet();}
+        void closeInlet();
 
         /**
          * @brief Wait until all the pooled threads shut down.
@@ -101,4 +440,11 @@ class ThreadPool {
         void join();
 };
 
+using ThreadPool = BasicThreadPool<>;
+
+extern template class BasicThreadPool<MutexQueuePolicy>;
+extern template class BasicThreadPool<LockFreeQueuePolicy>;
+extern template class BasicThreadPool<ShardedQueuePolicy>;
+extern template class BasicThreadPool<PriorityQueuePolicy>;
+
 #endif // __THREAD_POOL__
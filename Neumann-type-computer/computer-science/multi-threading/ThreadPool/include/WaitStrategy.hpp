@@ -0,0 +1,84 @@
+/**
+ * @file WaitStrategy.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief wait strategies for blocking queues
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __WAIT_STRATEGY__
+#define __WAIT_STRATEGY__
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+/**
+ * @brief how a thread waits for a queue to become not-full or not-empty
+ */
+enum class WaitStrategy {
+    BLOCK, // Park on the condition variable immediately.
+    SPIN_THEN_PARK // Spin with a pause instruction, then yield, then park. The spin budget adapts to the recently observed wait times.
+};
+
+/**
+ * @brief Tell the CPU that the caller is in a spin-wait loop.
+ */
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief spin-then-yield waiter whose spin budget follows the recently observed wait times
+ * @details When a wait is satisfied while spinning, the budget moves towards twice the number of the spins it took.
+ * When it is not (satisfied only after yielding, or the caller is going to park), spinning was wasted and the budget shrinks.
+ * On a single-CPU machine the thread being waited for cannot run while spinning, so only the yield phase is used.
+ */
+class AdaptiveSpinner {
+    private:
+        static constexpr unsigned int MIN_SPINS = 16;
+        static constexpr unsigned int MAX_SPINS = 4096;
+        static constexpr unsigned int NUM_YIELDS = 8;
+
+        std::atomic<unsigned int> m_spinBudget{(std::thread::hardware_concurrency() > 1) ? 1024u : 0u};
+
+    public:
+        /**
+         * @brief Spin, then yield, until `pred` returns `true` or the budget runs out.
+         *
+         * @tparam T_pred callable type which takes no argument and returns `bool`, must not block
+         * @param[in] pred the condition to wait for
+         * @retval true `pred` became `true`.
+         * @retval false The budget ran out; the caller should park.
+         */
+        template <typename T_pred>
+        bool spinUntil(T_pred pred) {
+            const unsigned int budget = m_spinBudget.load(std::memory_order_relaxed);
+            for (unsigned int i=0; i<budget; ++i) {
+                if (pred()) {
+                    const unsigned int target = std::clamp(2*i, MIN_SPINS, MAX_SPINS);
+                    m_spinBudget.store(budget - budget/8 + target/8, std::memory_order_relaxed);
+                    return true;
+                }
+                cpuRelax();
+            }
+            bool isSatisfied = false;
+            for (unsigned int i=0; (i<NUM_YIELDS) && !isSatisfied; ++i) {
+                std::this_thread::yield();
+                isSatisfied = pred();
+            }
+            if (budget > 0) {
+                m_spinBudget.store(std::max(budget - budget/8, MIN_SPINS), std::memory_order_relaxed);
+            }
+            return isSatisfied;
+        }
+};
+
+#endif // __WAIT_STRATEGY__
@@ -0,0 +1,154 @@
+/**
+ * @file WorkStealingDeque.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief bounded work-stealing deque based on the Chase-Lev deque (Chase and Lev, 2005; Le et al., 2013)
+ * @version 0.1.1
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __WORK_STEALING_DEQUE__
+#define __WORK_STEALING_DEQUE__
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "ConcurrencyUtil.hpp"
+
+/**
+ * @brief bounded single-owner multi-thief deque
+ * @details The owner thread pushes and pops at the bottom (LIFO) without any atomic read-modify-write except when one element is left;
+ * the other threads steal from the top (FIFO) with one CAS.
+ * Unlike the original Chase-Lev deque, the array does not grow: `push` fails when the deque is full, and the caller puts the element elsewhere.
+ * Each slot carries a sequence number, so a slot is not overwritten until the thief which took it has moved the element out.
+ * This lets the deque hold elements which are not trivially copyable, e.g. `std::shared_ptr`.
+ *
+ * @tparam T_elem the data type of elements, which must be default-constructible and move-assignable
+ */
+template <typename T_elem>
+class WorkStealingDeque {
+    private:
+
+        struct Slot {
+            std::atomic<int64_t> seq; // the index for which the slot is free
+            T_elem elem;
+        };
+
+        const int64_t m_capacity;
+        const int64_t m_mask;
+        const std::unique_ptr<Slot[]> m_slots;
+        alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_top{0}; // the index of the oldest element, advanced by thieves (and by the owner taking the last element)
+        alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom{0}; // the index next to the newest element, written only by the owner
+
+    public:
+        /**
+         * @brief Construct a new WorkStealingDeque object
+         *
+         * @param[in] capacity the max number of the elements, rounded up to a power of two, must be 1 or greater
+         */
+        explicit WorkStealingDeque(size_t capacity) : m_capacity(static_cast<int64_t>(ceilPow2(capacity))), m_mask(m_capacity - 1), m_slots(new Slot[m_capacity]) {
+            assert(capacity > 0);
+            for (int64_t i=0; i<m_capacity; ++i) {
+                m_slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        /**
+         * @brief Get the capacity of the deque
+         *
+         * @return capacity
+         */
+        size_t capacity() const {
+            return static_cast<size_t>(m_capacity);
+        }
+
+        /**
+         * @brief Check if the deque looks empty. The result may be stale as soon as it is returned.
+         */
+        bool empty() const {
+            return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Push an element at the bottom. Only the owner thread may call this.
+         *
+         * @param[in,out] elem the data to be pushed, moved from only on success
+         * @retval true The data was pushed.
+         * @retval false The deque was full.
+         */
+        bool push(T_elem &elem) {
+            const int64_t b = m_bottom.load(std::memory_order_relaxed);
+            Slot &slot = m_slots[b & m_mask];
+            if (slot.seq.load(std::memory_order_acquire) != b) {
+                return false; // full, or a thief is still moving the element out of this slot
+            }
+            slot.elem = std::move(elem);
+            m_bottom.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Pop the newest element from the bottom. Only the owner thread may call this.
+         *
+         * @param[out] elem the reference to the data which the popped data to be moved into
+         * @retval true The data was popped.
+         * @retval false The deque was empty, or the last element was stolen.
+         */
+        bool pop(T_elem &elem) {
+            const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(b, std::memory_order_release); // Every store is a release, so a thief reading any value of `m_bottom` sees the elements below it.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = m_top.load(std::memory_order_relaxed);
+            if (t > b) {
+                m_bottom.store(b + 1, std::memory_order_release);
+                return false;
+            }
+            Slot &slot = m_slots[b & m_mask];
+            if (t < b) {
+                elem = std::move(slot.elem);
+                slot.seq.store(b, std::memory_order_relaxed); // The next push reuses the index `b`.
+                return true;
+            }
+            /* the last element: race with the thieves on `m_top` */
+            const bool isWon = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_release);
+            if (!isWon) {
+                return false;
+            }
+            elem = std::move(slot.elem);
+            slot.seq.store(b + m_capacity, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Steal the oldest element from the top. Any thread may call this.
+         *
+         * @param[out] elem the reference to the data which the stolen data to be moved into
+         * @retval true The data was stolen.
+         * @retval false The deque was empty, or another thread took the element first.
+         */
+        bool steal(T_elem &elem) {
+            int64_t t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = m_bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return false;
+            }
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+            Slot &slot = m_slots[t & m_mask];
+            elem = std::move(slot.elem);
+            slot.seq.store(t + m_capacity, std::memory_order_release);
+            return true;
+        }
+};
+
+#endif // __WORK_STEALING_DEQUE__
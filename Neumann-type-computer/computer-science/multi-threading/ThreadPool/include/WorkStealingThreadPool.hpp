@@ -0,0 +1,150 @@
+/**
+ * @file WorkStealingThreadPool.hpp
+ * @author motchy (motchy869@gmail.com)
+ * @brief thread pool whose workers keep their own task deques and steal from each other
+ * @version 0.1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 motchy
+ * https://motchy869.com/wordpress/
+ * Released under the MIT license
+ */
+
+#ifndef __WORK_STEALING_THREAD_POOL__
+#define __WORK_STEALING_THREAD_POOL__
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "EventCount.hpp"
+#include "MultiThreadQueue.hpp"
+#include "ThreadPool.hpp"
+#include "WorkStealingDeque.hpp"
+
+/**
+ * @brief thread pool with work stealing, a drop-in replacement of `ThreadPool` (`pushExecutable`/`closeInlet`/`join`) for many short tasks
+ * @details Each pooled thread has its own `WorkStealingDeque`:
+ * @par 1. `pushExecutable` called from a pooled thread (i.e. from `Executable::run`) pushes to the deque of that thread, without any lock.
+ * @par 2. `pushExecutable` called from other threads pushes to a shared injection queue, from which the pooled threads take tasks in batches.
+ * @par 3. A pooled thread runs the tasks of its own deque newest first; when it runs out of tasks, it takes a batch from the injection queue, then steals the oldest task of a randomly chosen other thread.
+ * So the shared queue is locked once per batch instead of once per task, and a task and its subtasks mostly stay on one core.
+ * Threads sleep (in `EventCount`) only when no task is found anywhere.
+ */
+class WorkStealingThreadPool {
+    private:
+        static constexpr size_t DEQUE_CAPACITY = 1024; // per pooled thread; tasks overflow to the injection queue
+        static constexpr size_t INJECTION_BATCH_SIZE = 32; // the max number of the tasks taken from the injection queue at once
+        static constexpr unsigned int NUM_SPINS_BEFORE_SLEEP = 64; // the number of the yield-and-search rounds before sleeping
+
+        struct Worker {
+            WorkStealingDeque<std::shared_ptr<Executable>> deque{DEQUE_CAPACITY};
+        };
+
+        const unsigned int m_numThreads;
+        const std::unique_ptr<Worker[]> m_workers;
+        MultiThreadQueue<std::shared_ptr<Executable>> m_injectionQueue;
+        std::atomic<bool> m_isClosed{false};
+        EventCount m_ec_work;
+        std::vector<std::thread> m_threads;
+        std::mutex m_threadsMtx; // held while the threads are being created
+        std::mutex m_joinMtx;
+
+        /**
+         * @brief Get the index of the caller thread in this pool.
+         *
+         * @return the index, or `m_numThreads` if the caller is not a pooled thread of this pool
+         */
+        unsigned int currentWorkerIndex() const;
+
+        /**
+         * @brief Find a task: from the deque of the worker, from the injection queue, then from the other workers.
+         *
+         * @retval true A task was found and moved to `exe`.
+         * @retval false No task was found.
+         */
+        bool findTask(unsigned int index, std::shared_ptr<Executable> &exe);
+
+        /**
+         * @brief Check if a task may be found somewhere, or the pool is closed. Used as the predicate of sleeping.
+         */
+        bool hasVisibleWorkOrClosed();
+
+        /**
+         * @brief the loop of a pooled thread
+         */
+        void thread_runExecutables(unsigned int index);
+
+    public:
+        /**
+         * @brief Construct a new WorkStealingThreadPool object
+         *
+         * @param[in] numThreads the number of the threads to be created
+         * @param[in] queueDepth the depth of the injection queue for sending Executable objects from outside the pool
+         */
+        WorkStealingThreadPool(unsigned int numThreads, unsigned int queueDepth);
+
+        WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+        WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+        /**
+         * @brief Get the number of the pooled threads
+         *
+         * @return the number of the pooled threads
+         */
+        size_t numThreads() const {return m_numThreads;}
+
+        /**
+         * @brief Push a new Executable object to the pool.
+         * @details From a pooled thread, the object goes to the deque of that thread (or to the injection queue if the deque is full, or is run at once in the caller thread if both are full: a pooled thread never blocks here).
+         * From other threads, the object goes to the injection queue; if the injection queue is full, the caller thread is blocked until it is not-full or is closed.
+         *
+         * @param[in] ptr_exe std::shared_ptr of an Executable object
+         * @retval true The object was successfully pushed.
+         * @retval false The pool was already closed, or became closed during waiting for the injection queue to be not-full.
+         */
+        bool pushExecutable(std::shared_ptr<Executable> ptr_exe);
+
+        /**
+         * @brief Construct a new Executable object and push it to the pool, as `pushExecutable`.
+         *
+         * @tparam T_executable concrete class inheriting `Executable`
+         * @tparam T_args the types of the constructor arguments
+         * @param[in] args the arguments forwarded to the constructor of `T_executable`
+         * @retval true The object was successfully pushed.
+         * @retval false The pool was already closed, or became closed during waiting for the injection queue to be not-full.
+         */
+        template <typename T_executable, typename... T_args>
+        bool emplaceExecutable(T_args&&... args) {return pushExecutable(std::make_shared<T_executable>(std::forward<T_args>(args)...));}
+
+        /**
+         * @brief Take all the pending Executable objects out of the pool and return them to the caller.
+         * @details The injection queue is drained and the deques of the pooled threads are emptied by stealing. Tasks pushed concurrently may be missed.
+         *
+         * @return the pending Executable objects
+         */
+        std::deque<std::shared_ptr<Executable>> drainExecutables();
+
+        /**
+         * @brief Pops all pending Executable objects from the pool.
+         */
+        void popAllExecutables() {drainExecutables();}
+
+        /**
+         * @brief Close the pool inlet. No more Executable objects can be pushed after this operation, even from the pooled threads.
+         * @details After the inlet is closed:
+         * @par 1. following or currently-blocked `pushExecutable` callings return with `false`.
+         * @par 2. After all the pending tasks have run, all the pooled threads shut down.
+         */
+        void closeInlet();
+
+        /**
+         * @brief Wait until all the pooled threads shut down.
+         * @details One typically calls `pushExecutable` method repeatedly until all the tasks are pushed, then calls `closeInlet` method, finally calls `join` method.
+         */
+        void join();
+};
+
+#endif // __WORK_STEALING_THREAD_POOL__
@@ -1,28 +1,120 @@
 #include "../include/ThreadPool.hpp"
 
-static void thread_runExecutable(std::reference_wrapper<std::mutex> ref_threadsCreationMutex, ThreadInfo threadInfo, std::reference_wrapper<MultiThreadQueue<std::shared_ptr<Executable>>> ref_queue) {
+namespace {
+    /**
+     * @brief the pool and the thread id of the current thread, set by each pooled thread
+     */
+    struct CurrentWorker {
+        const void *pool = nullptr;
+        unsigned int threadId = 0;
+    };
+
+    thread_local CurrentWorker t_currentWorker;
+}
+
+template <typename T_queuePolicy>
+void BasicThreadPool<T_queuePolicy>::thread_runExecutables(ThreadInfo threadInfo) {
     /* Wait until all the other threads be created, otherwise the constructor is blocked and cannot create other threads. */
-    std::unique_lock<std::mutex> lock(ref_threadsCreationMutex.get());
+    std::unique_lock<std::mutex> lock(m_threadsMtx);
     lock.unlock();
     std::this_thread::sleep_for(std::chrono::microseconds(100));
 
-    MultiThreadQueue<std::shared_ptr<Executable>> &queue = ref_queue.get();
-    std::shared_ptr<Executable> exe;
-    while (queue.pop(exe)) {
-        exe->run(threadInfo);
+    t_currentWorker = CurrentWorker{this, threadInfo.threadId};
+    PoolTask task;
+    for (;;) {
+        while (m_queue.pop(task)) {
+            task(threadInfo);
+        }
+        task.reset();
+
+        /* The queue was closed by `closeInlet` (shut down) or by `finishBatch` (wait for the next batch). */
+        std::unique_lock<std::mutex> batchLock(m_batchMtx);
+        if (m_isClosed) {
+            t_currentWorker = CurrentWorker{};
+            return;
+        }
+        const size_t generation = m_batchGeneration;
+        if (++m_numIdleThreads == m_numThreads) {
+            m_cv_batch.notify_all();
+        }
+        m_cv_batch.wait(batchLock, [&]{return m_isClosed || (m_batchGeneration != generation);});
     }
 }
 
-ThreadPool::ThreadPool(unsigned int numThreads, unsigned int queueDepth) : m_numThreads(numThreads), m_threads(numThreads), m_queue(queueDepth) {
+template <typename T_queuePolicy>
+BasicThreadPool<T_queuePolicy>::BasicThreadPool(unsigned int numThreads, unsigned int queueDepth) : m_numThreads(numThreads), m_threads(numThreads), m_queue(queueDepth) {
     std::lock_guard<std::mutex> lock(m_threadsMtx);
     for (unsigned int i=0; i<m_numThreads; ++i) {
-        m_threads.emplace_back(thread_runExecutable, std::ref(m_threadsMtx), (ThreadInfo){.threadId=i}, std::ref(m_queue));
+        m_threads.emplace_back(&BasicThreadPool::thread_runExecutables, this, (ThreadInfo){.threadId=i});
     }
 }
 
-void ThreadPool::join() {
-    std::lock_guard<std::mutex> lock(m_threadsMtx);
+template <typename T_queuePolicy>
+bool BasicThreadPool<T_queuePolicy>::runPendingTask() {
+    if (t_currentWorker.pool != this) {
+        return false;
+    }
+    PoolTask task;
+    if constexpr (std::is_same_v<decltype(m_queue.tryPop(task)), QueueOpStatus>) {
+        if (m_queue.tryPop(task) != QueueOpStatus::SUCCESS) {
+            return false;
+        }
+    } else {
+        if (!m_queue.tryPop(task)) {
+            return false;
+        }
+    }
+    task(ThreadInfo{.threadId=t_currentWorker.threadId});
+    return true;
+}
+
+template <typename T_queuePolicy>
+std::deque<std::shared_ptr<Executable>> BasicThreadPool<T_queuePolicy>::drainExecutables() {
+    std::deque<PoolTask> tasks = m_queue.drain();
+    std::deque<std::shared_ptr<Executable>> drained;
+    for (PoolTask &task : tasks) {
+        drained.push_back(std::move(task).toExecutable());
+    }
+    return drained;
+}
+
+template <typename T_queuePolicy>
+bool BasicThreadPool<T_queuePolicy>::finishBatch() {
+    std::unique_lock<std::mutex> lock(m_batchMtx);
+    if (m_isClosed) {
+        return false;
+    }
+    m_queue.closeInlet(); // Let the pooled threads run out the queue and report idle.
+    m_cv_batch.wait(lock, [&]{return m_isClosed || (m_numIdleThreads == m_numThreads);});
+    if (m_isClosed) {
+        return false;
+    }
+    m_numIdleThreads = 0;
+    m_queue.reopenInlet();
+    ++m_batchGeneration;
+    m_cv_batch.notify_all();
+    return true;
+}
+
+template <typename T_queuePolicy>
+void BasicThreadPool<T_queuePolicy>::closeInlet() {
+    {
+        std::lock_guard<std::mutex> lock(m_batchMtx);
+        m_isClosed = true;
+    }
+    m_queue.closeInlet();
+    m_cv_batch.notify_all();
+}
+
+template <typename T_queuePolicy>
+void BasicThreadPool<T_queuePolicy>::join() {
+    std::lock_guard<std::mutex> lock(m_joinMtx);
     for (auto &th : m_threads) {
         if (th.joinable()) {th.join();}
     }
 }
+
+template class BasicThreadPool<MutexQueuePolicy>;
+template class BasicThreadPool<LockFreeQueuePolicy>;
+template class BasicThreadPool<ShardedQueuePolicy>;
+template class BasicThreadPool<PriorityQueuePolicy>;
@@ -0,0 +1,160 @@
+#include <array>
+#include "../include/ConcurrencyUtil.hpp"
+#include "../include/WorkStealingThreadPool.hpp"
+
+namespace {
+    /**
+     * @brief the pool and the index of the current thread, set by each pooled thread
+     */
+    struct CurrentWorker {
+        const WorkStealingThreadPool *pool = nullptr;
+        unsigned int index = 0;
+    };
+
+    thread_local CurrentWorker t_currentWorker;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(unsigned int numThreads, unsigned int queueDepth) : m_numThreads(numThreads), m_workers(new Worker[numThreads]), m_injectionQueue(queueDepth) {
+    std::lock_guard<std::mutex> lock(m_threadsMtx);
+    m_threads.reserve(m_numThreads);
+    for (unsigned int i=0; i<m_numThreads; ++i) {
+        m_threads.emplace_back(&WorkStealingThreadPool::thread_runExecutables, this, i);
+    }
+}
+
+unsigned int WorkStealingThreadPool::currentWorkerIndex() const {
+    return (t_currentWorker.pool == this) ? t_currentWorker.index : m_numThreads;
+}
+
+bool WorkStealingThreadPool::findTask(unsigned int index, std::shared_ptr<Executable> &exe) {
+    Worker &self = m_workers[index];
+    if (self.deque.pop(exe)) {
+        return true;
+    }
+
+    /* Take a batch from the injection queue: run the first task and keep the others in the own deque, where the other workers can steal them. */
+    std::array<std::shared_ptr<Executable>, INJECTION_BATCH_SIZE> batch;
+    const size_t numTaken = m_injectionQueue.tryPopBulk(batch.begin(), batch.size());
+    if (numTaken > 0) {
+        exe = std::move(batch[0]);
+        for (size_t i=1; i<numTaken; ++i) {
+            if (!self.deque.push(batch[i])) {
+                /* The deque is empty, but a thief may still be moving an element out of the slot to be reused: run the task here rather than drop it. */
+                batch[i]->run(ThreadInfo{.threadId=index});
+                batch[i].reset();
+            }
+        }
+        if (numTaken > 1) {
+            m_ec_work.notifyOne();
+        }
+        return true;
+    }
+
+    /* Steal from the others, starting at a random victim. */
+    const unsigned int start = static_cast<unsigned int>(xorshiftRandom() % m_numThreads);
+    for (unsigned int k=0; k<m_numThreads; ++k) {
+        const unsigned int victim = (start + k) % m_numThreads;
+        if ((victim != index) && m_workers[victim].deque.steal(exe)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::hasVisibleWorkOrClosed() {
+    if (m_isClosed.load(std::memory_order_seq_cst) || m_injectionQueue.isReadyToPop()) {
+        return true;
+    }
+    for (unsigned int i=0; i<m_numThreads; ++i) {
+        if (!m_workers[i].deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::thread_runExecutables(unsigned int index) {
+    /* Wait until all the other threads be created, otherwise the constructor is blocked and cannot create other threads. */
+    {std::lock_guard<std::mutex> lock(m_threadsMtx);}
+    t_currentWorker = CurrentWorker{this, index};
+
+    const ThreadInfo threadInfo{.threadId=index};
+    std::shared_ptr<Executable> exe;
+    unsigned int numFailedSearches = 0;
+    for (;;) {
+        /* Read the closure before searching, so that every task pushed before closing is found by the search. */
+        const bool isClosed = m_isClosed.load(std::memory_order_seq_cst);
+        if (findTask(index, exe)) {
+            exe->run(threadInfo);
+            exe.reset();
+            numFailedSearches = 0;
+            continue;
+        }
+        if (isClosed) {
+            break; // The remaining tasks, if any, are in the deques of the other workers, which run them before shutting down.
+        }
+        if (++numFailedSearches < NUM_SPINS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+            continue;
+        }
+        m_ec_work.wait([this]{return hasVisibleWorkOrClosed();});
+        numFailedSearches = 0;
+    }
+    t_currentWorker = CurrentWorker{};
+}
+
+bool WorkStealingThreadPool::pushExecutable(std::shared_ptr<Executable> ptr_exe) {
+    if (m_isClosed.load(std::memory_order_acquire)) {
+        return false;
+    }
+    const unsigned int index = currentWorkerIndex();
+    if (index < m_numThreads) {
+        if (m_workers[index].deque.push(ptr_exe)) {
+            m_ec_work.notifyOne();
+            return true;
+        }
+        /* Only the workers drain the injection queue, so a worker must not block on it: if every worker did, the pool would deadlock. Run the task here when the queue is full. */
+        switch (m_injectionQueue.tryPush(std::move(ptr_exe))) {
+            case QueueOpStatus::SUCCESS:
+                m_ec_work.notifyOne();
+                return true;
+            case QueueOpStatus::CLOSED:
+                return false;
+            default:
+                ptr_exe->run(ThreadInfo{.threadId=index});
+                return true;
+        }
+    }
+    if (!m_injectionQueue.push(std::move(ptr_exe))) {
+        return false;
+    }
+    m_ec_work.notifyOne();
+    return true;
+}
+
+std::deque<std::shared_ptr<Executable>> WorkStealingThreadPool::drainExecutables() {
+    std::deque<std::shared_ptr<Executable>> drained = m_injectionQueue.drain();
+    std::shared_ptr<Executable> exe;
+    for (unsigned int i=0; i<m_numThreads; ++i) {
+        while (!m_workers[i].deque.empty()) {
+            if (m_workers[i].deque.steal(exe)) {
+                drained.push_back(std::move(exe));
+            }
+        }
+    }
+    return drained;
+}
+
+void WorkStealingThreadPool::closeInlet() {
+    /* Close the injection queue first: a `pushExecutable` which passed the check of `m_isClosed` either lands in the queue before the workers can see `m_isClosed`, or is rejected by the queue. */
+    m_injectionQueue.closeInlet();
+    m_isClosed.store(true, std::memory_order_seq_cst);
+    m_ec_work.notifyAll();
+}
+
+void WorkStealingThreadPool::join() {
+    std::lock_guard<std::mutex> lock(m_joinMtx);
+    for (auto &th : m_threads) {
+        if (th.joinable()) {th.join();}
+    }
+}